@@ -0,0 +1,201 @@
+//
+//  arena.h
+//  Final Project CSC412
+//
+//	Bump allocator.  Memory comes from a few large chunks and gets handed
+//	out by moving an offset, so an allocation is a handful of instructions
+//	and never a call to the heap once the chunks are there.  Nothing is
+//	freed on its own:  release() frees everything at once (running the
+//	destructors of what create() built), and rewind() takes the arena back
+//	to an earlier mark() while keeping its chunks for the next user.
+//
+//	The simulation keeps what lives as long as the world (the partitions
+//	and their blocks) in one arena, and each thread has a scratch arena
+//	(scratchArena()) for the temporary buffers of a step, rewound at the
+//	end of the step.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**	Fixed-size array in an arena (the arena owns the elements)
+ */
+template <typename T>
+class ArenaArray
+{
+	public:
+
+		ArenaArray() = default;
+		ArenaArray(T* data, size_t count) : first(data), count(count) {}
+
+		T* begin() { return first; }
+		T* end() { return first + count; }
+		const T* begin() const { return first; }
+		const T* end() const { return first + count; }
+
+		size_t size() const { return count; }
+		bool empty() const { return count == 0; }
+
+		T& operator[](size_t k) { return first[k]; }
+		const T& operator[](size_t k) const { return first[k]; }
+		T& front() { return first[0]; }
+		const T& front() const { return first[0]; }
+		T& back() { return first[count-1]; }
+		const T& back() const { return first[count-1]; }
+
+	private:
+
+		T* first = nullptr;
+		size_t count = 0;
+};
+
+class Arena
+{
+	public:
+
+		/**	Position of the arena, to rewind() to
+		 */
+		struct Mark
+		{
+			size_t chunk;
+			size_t offset;
+		};
+
+		Arena() = default;
+		~Arena() { release(); }
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		/**	@return size bytes of uninitialized memory, aligned on alignment
+		 *	(a power of two)
+		 */
+		void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			for (; current < chunkList.size(); current++, offset = 0)
+			{
+				Chunk& chunk = chunkList[current];
+				uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data);
+				size_t start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+				if (start + size <= chunk.size)
+				{
+					offset = start + size;
+					return chunk.data + start;
+				}
+			}
+
+			//	none of the chunks has room left:  add one, at least twice
+			//	as big as the previous one
+			size_t chunkSize = chunkList.empty() ? MIN_CHUNK_SIZE : 2 * chunkList.back().size;
+			while (chunkSize < size + alignment)
+				chunkSize *= 2;
+			chunkList.push_back({static_cast<char*>(::operator new(chunkSize)), chunkSize});
+			current = chunkList.size() - 1;
+			offset = 0;
+			return allocate(size, alignment);
+		}
+
+		/**	Builds an object in the arena.  Its destructor runs at release()
+		 *	(so don't rewind() past it).
+		 */
+		template <typename T, typename... Args>
+		T* create(Args&&... args)
+		{
+			T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			if (!std::is_trivially_destructible<T>::value)
+			{
+				Finalizer* finalizer = new (allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer;
+				finalizer->destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+				finalizer->object = object;
+				finalizer->next = finalizerList;
+				finalizerList = finalizer;
+			}
+			return object;
+		}
+
+		/**	@return count value-initialized elements
+		 */
+		template <typename T>
+		ArenaArray<T> createArray(size_t count)
+		{
+			static_assert(std::is_trivially_destructible<T>::value,
+						  "arena arrays are never destroyed, only released");
+			T* data = static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+			for (size_t k=0; k<count; k++)
+				new (data + k) T();
+			return ArenaArray<T>(data, count);
+		}
+
+		Mark mark() const { return {current, offset}; }
+
+		/**	Hands out again everything allocated since the mark was taken
+		 */
+		void rewind(const Mark& m)
+		{
+			current = m.chunk;
+			offset = m.offset;
+		}
+
+		/**	Destroys what create() built, and gives the chunks back to the heap
+		 */
+		void release()
+		{
+			for (; finalizerList != nullptr; finalizerList = finalizerList->next)
+				finalizerList->destroy(finalizerList->object);
+			for (Chunk& chunk : chunkList)
+				::operator delete(chunk.data);
+			chunkList.clear();
+			current = offset = 0;
+		}
+
+		/**	Bytes taken from the heap
+		 */
+		size_t capacity() const
+		{
+			size_t total = 0;
+			for (const Chunk& chunk : chunkList)
+				total += chunk.size;
+			return total;
+		}
+
+	private:
+
+		static const size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+		struct Chunk
+		{
+			char* data;
+			size_t size;
+		};
+
+		//	destructor to run at release(), most recent first
+		struct Finalizer
+		{
+			void (*destroy)(void*);
+			void* object;
+			Finalizer* next;
+		};
+
+		std::vector<Chunk> chunkList;
+		//	chunk being filled, and first free byte in it
+		size_t current = 0;
+		size_t offset = 0;
+		Finalizer* finalizerList = nullptr;
+};
+
+/**	The calling thread's scratch arena.  Take a mark() before using it and
+ *	rewind() to it when done, so that it never grows past the largest need.
+ */
+inline Arena& scratchArena()
+{
+	thread_local Arena arena;
+	return arena;
+}
+
+#endif //	ARENA_H
@@ -0,0 +1,376 @@
+//
+//  arguments.cpp
+//  Final Project CSC412
+//
+//	Command-line parsing shared by all the drivers.
+//
+//	usage:	prog [--rows N] [--cols N] [--travelers N] [--partitions N] [--threads N] [--seed N] [--sleep usec]
+//			[--engine mutex,cas,tick,region] [--locks cell|tile|stripe|global] [--lock-tile N]
+//			[--lock-stripes N] [--max-ticks N] [--processes N] [--transport shm|tcp]
+//			[--segments N] [--grow N] [--max-segments N] [--routing random|gradient]
+//			[--epsilon P] [--maze classic|tiled] [--maze-tile N]
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+//
+#include <getopt.h>
+#include "simulation.h"
+
+using namespace std;
+
+//	Defaults, used when an option is not given and the driver did not set
+//	the variable beforehand
+const unsigned int DEFAULT_NUM_ROWS = 30;
+const unsigned int DEFAULT_NUM_COLS = 35;
+const unsigned int DEFAULT_NUM_TRAVELERS = 12;
+
+//	The wall and partition generators need a grid at least this big in
+//	each dimension.  The upper bound is just a sanity check.
+const unsigned int MIN_GRID_DIM = 12;
+const unsigned int MAX_GRID_DIM = 20000;
+const unsigned int MAX_NUM_WORKERS = 1024;
+const unsigned int MAX_NUM_PROCESSES = 64;
+const unsigned int MAX_NUM_SEGMENTS = 1024;
+
+//	Codes of the options that only have a long form
+enum
+{
+	OPT_LOCK_TILE = 256,
+	OPT_LOCK_STRIPES,
+	OPT_PARTITIONS,
+	OPT_TRANSPORT,
+	OPT_SEGMENTS,
+	OPT_GROW,
+	OPT_MAX_SEGMENTS,
+	OPT_ROUTING,
+	OPT_EPSILON,
+	OPT_MAZE,
+	OPT_MAZE_TILE
+};
+
+static void printUsage(const char* progName)
+{
+	fprintf(stderr,
+			"usage: %s [options]\n"
+			"  -r, --rows N        number of grid rows (default %u)\n"
+			"  -c, --cols N        number of grid columns (default %u)\n"
+			"  -t, --travelers N   number of travelers (default %u)\n"
+			"      --partitions N  number of sliding partitions (default: about (rows+cols)/4)\n"
+			"  -j, --threads N     number of worker threads (default: one per core)\n"
+			"  -s, --seed N        seed of the random generators (default: random)\n"
+			"  -z, --sleep N       travelers' sleep time between moves, in microseconds\n"
+			"  -e, --engine LIST   comma-separated engine modes: mutex, cas, tick, region\n"
+			"                      (default mutex); the headless driver runs each one in turn\n"
+			"  -l, --locks MODE    grid lock granularity: cell, tile, stripe, global (default cell)\n"
+			"      --lock-tile N   side of a lock tile, in squares (default %u)\n"
+			"      --lock-stripes N  number of hashed locks in stripe mode (default %u)\n"
+			"  -m, --max-ticks N   stop after N ticks even if travelers are left (default: no limit)\n"
+			"  -p, --processes N   number of processes of a distributed run (default %u)\n"
+			"      --transport T   how those processes talk: shm, tcp (default shm)\n"
+			"      --segments N    segments each traveler starts with, room permitting (default %u)\n"
+			"      --grow N        a traveler grows one segment every N moves (default: never)\n"
+			"      --max-segments N  most segments a traveler can have (default: --segments,\n"
+			"                      or 32 with --grow)\n"
+			"      --routing MODE  how travelers pick directions: random, or gradient\n"
+			"                      (down the distance to the exit) (default random)\n"
+			"      --epsilon P     fraction of random moves in gradient mode (default %.2f)\n"
+			"      --maze MODE     how the maze gets generated: classic, or tiled (in\n"
+			"                      parallel, for large grids) (default classic)\n"
+			"      --maze-tile N   smallest side of a tile of the tiled maze (default %u)\n"
+			"  -h, --help          print this message\n",
+			progName, numRows, numCols, numTravelers, lockTileSize, numLockStripes, numProcesses,
+			numInitialSegments, explorationRate, mazeTileSize);
+}
+
+//	Reads an unsigned integer argument, rejecting garbage and out-of-range values
+static unsigned long readUnsigned(const char* progName, const char* optName,
+								  const char* str, unsigned long minVal, unsigned long maxVal)
+{
+	char* end;
+	errno = 0;
+	unsigned long val = strtoul(str, &end, 10);
+	if (errno != 0 || end == str || *end != '\0' || str[0] == '-' ||
+		val < minVal || val > maxVal)
+	{
+		fprintf(stderr, "%s: invalid value \"%s\" for --%s (must be in [%lu, %lu])\n",
+				progName, str, optName, minVal, maxVal);
+		exit(1);
+	}
+	return val;
+}
+
+//	Reads a number in [0, 1]
+static double readFraction(const char* progName, const char* optName, const char* str)
+{
+	char* end;
+	errno = 0;
+	double val = strtod(str, &end);
+	if (errno != 0 || end == str || *end != '\0' || !(val >= 0.0 && val <= 1.0))
+	{
+		fprintf(stderr, "%s: invalid value \"%s\" for --%s (must be in [0, 1])\n",
+				progName, str, optName);
+		exit(1);
+	}
+	return val;
+}
+
+//	Reads a comma-separated list of engine names into engineModeList
+static void readEngineModes(const char* progName, const char* str)
+{
+	engineModeList.clear();
+	string list(str);
+	size_t start = 0;
+	while (start <= list.size())
+	{
+		size_t end = list.find(',', start);
+		if (end == string::npos)
+			end = list.size();
+		string name = list.substr(start, end - start);
+
+		bool found = false;
+		for (int k=0; k<static_cast<int>(EngineMode::NUM_ENGINE_MODES) && !found; k++)
+		{
+			EngineMode mode = static_cast<EngineMode>(k);
+			if (name == engineStr(mode))
+			{
+				engineModeList.push_back(mode);
+				found = true;
+			}
+		}
+		if (!found)
+		{
+			fprintf(stderr, "%s: unknown engine \"%s\"\n", progName, name.c_str());
+			exit(1);
+		}
+		start = end + 1;
+	}
+}
+
+static void readTransportMode(const char* progName, const char* str)
+{
+	for (int k=0; k<static_cast<int>(TransportMode::NUM_TRANSPORT_MODES); k++)
+	{
+		if (transportStr(static_cast<TransportMode>(k)) == str)
+		{
+			transportMode = static_cast<TransportMode>(k);
+			return;
+		}
+	}
+	fprintf(stderr, "%s: unknown transport \"%s\"\n", progName, str);
+	exit(1);
+}
+
+static void readRoutingMode(const char* progName, const char* str)
+{
+	for (int k=0; k<static_cast<int>(RoutingMode::NUM_ROUTING_MODES); k++)
+	{
+		if (routingStr(static_cast<RoutingMode>(k)) == str)
+		{
+			routingMode = static_cast<RoutingMode>(k);
+			return;
+		}
+	}
+	fprintf(stderr, "%s: unknown routing mode \"%s\"\n", progName, str);
+	exit(1);
+}
+
+static void readMazeMode(const char* progName, const char* str)
+{
+	for (int k=0; k<static_cast<int>(MazeMode::NUM_MAZE_MODES); k++)
+	{
+		if (mazeStr(static_cast<MazeMode>(k)) == str)
+		{
+			mazeMode = static_cast<MazeMode>(k);
+			return;
+		}
+	}
+	fprintf(stderr, "%s: unknown maze mode \"%s\"\n", progName, str);
+	exit(1);
+}
+
+static void readLockGranularity(const char* progName, const char* str)
+{
+	for (int k=0; k<static_cast<int>(LockGranularity::NUM_LOCK_GRANULARITIES); k++)
+	{
+		if (lockStr(static_cast<LockGranularity>(k)) == str)
+		{
+			lockGranularity = static_cast<LockGranularity>(k);
+			return;
+		}
+	}
+	fprintf(stderr, "%s: unknown lock granularity \"%s\"\n", progName, str);
+	exit(1);
+}
+
+void parseArguments(int argc, char* argv[])
+{
+	static const struct option longOptions[] = {
+		{"rows",		required_argument,	nullptr, 'r'},
+		{"cols",		required_argument,	nullptr, 'c'},
+		{"travelers",	required_argument,	nullptr, 't'},
+		{"partitions",	required_argument,	nullptr, OPT_PARTITIONS},
+		{"threads",		required_argument,	nullptr, 'j'},
+		{"seed",		required_argument,	nullptr, 's'},
+		{"sleep",		required_argument,	nullptr, 'z'},
+		{"engine",		required_argument,	nullptr, 'e'},
+		{"locks",		required_argument,	nullptr, 'l'},
+		{"lock-tile",	required_argument,	nullptr, OPT_LOCK_TILE},
+		{"lock-stripes",	required_argument,	nullptr, OPT_LOCK_STRIPES},
+		{"max-ticks",	required_argument,	nullptr, 'm'},
+		{"processes",	required_argument,	nullptr, 'p'},
+		{"transport",	required_argument,	nullptr, OPT_TRANSPORT},
+		{"segments",	required_argument,	nullptr, OPT_SEGMENTS},
+		{"grow",		required_argument,	nullptr, OPT_GROW},
+		{"max-segments",	required_argument,	nullptr, OPT_MAX_SEGMENTS},
+		{"routing",		required_argument,	nullptr, OPT_ROUTING},
+		{"epsilon",		required_argument,	nullptr, OPT_EPSILON},
+		{"maze",		required_argument,	nullptr, OPT_MAZE},
+		{"maze-tile",	required_argument,	nullptr, OPT_MAZE_TILE},
+		{"help",		no_argument,		nullptr, 'h'},
+		{nullptr, 0, nullptr, 0}
+	};
+
+	//	a driver may have set its own defaults before calling us
+	if (numRows == 0)
+		numRows = DEFAULT_NUM_ROWS;
+	if (numCols == 0)
+		numCols = DEFAULT_NUM_COLS;
+	if (numTravelers == 0)
+		numTravelers = DEFAULT_NUM_TRAVELERS;
+	bool haveSeed = false;
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, "r:c:t:j:s:z:e:l:m:p:h", longOptions, nullptr)) != -1)
+	{
+		switch (opt)
+		{
+			case 'r':
+				numRows = readUnsigned(argv[0], "rows", optarg, MIN_GRID_DIM, MAX_GRID_DIM);
+				break;
+
+			case 'c':
+				numCols = readUnsigned(argv[0], "cols", optarg, MIN_GRID_DIM, MAX_GRID_DIM);
+				break;
+
+			case 't':
+				numTravelers = readUnsigned(argv[0], "travelers", optarg, 1, UINT_MAX);
+				break;
+
+			case OPT_PARTITIONS:
+				numPartitions = readUnsigned(argv[0], "partitions", optarg, 0, NO_PARTITION - 1);
+				break;
+
+			case 'j':
+				numWorkers = readUnsigned(argv[0], "threads", optarg, 1, MAX_NUM_WORKERS);
+				break;
+
+			case 's':
+				randomSeed = readUnsigned(argv[0], "seed", optarg, 0, ULONG_MAX);
+				haveSeed = true;
+				break;
+
+			case 'z':
+				travelerSleepTime = readUnsigned(argv[0], "sleep", optarg, 0, INT_MAX);
+				break;
+
+			case 'e':
+				readEngineModes(argv[0], optarg);
+				break;
+
+			case 'l':
+				readLockGranularity(argv[0], optarg);
+				break;
+
+			case OPT_LOCK_TILE:
+				lockTileSize = readUnsigned(argv[0], "lock-tile", optarg, 1, MAX_GRID_DIM);
+				break;
+
+			case OPT_LOCK_STRIPES:
+				numLockStripes = readUnsigned(argv[0], "lock-stripes", optarg, 1, UINT_MAX);
+				break;
+
+			case 'm':
+				maxNumTicks = readUnsigned(argv[0], "max-ticks", optarg, 0, ULONG_MAX);
+				break;
+
+			case 'p':
+				numProcesses = readUnsigned(argv[0], "processes", optarg, 1, MAX_NUM_PROCESSES);
+				break;
+
+			case OPT_TRANSPORT:
+				readTransportMode(argv[0], optarg);
+				break;
+
+			case OPT_SEGMENTS:
+				numInitialSegments = readUnsigned(argv[0], "segments", optarg, 1, MAX_NUM_SEGMENTS);
+				break;
+
+			case OPT_GROW:
+				movesPerGrowth = readUnsigned(argv[0], "grow", optarg, 0, UINT_MAX);
+				break;
+
+			case OPT_MAX_SEGMENTS:
+				maxNumSegments = readUnsigned(argv[0], "max-segments", optarg, 1, MAX_NUM_SEGMENTS);
+				break;
+
+			case OPT_ROUTING:
+				readRoutingMode(argv[0], optarg);
+				break;
+
+			case OPT_EPSILON:
+				explorationRate = readFraction(argv[0], "epsilon", optarg);
+				break;
+
+			case OPT_MAZE:
+				readMazeMode(argv[0], optarg);
+				break;
+
+			case OPT_MAZE_TILE:
+				mazeTileSize = readUnsigned(argv[0], "maze-tile", optarg, MIN_GRID_DIM, MAX_GRID_DIM);
+				break;
+
+			case 'h':
+				printUsage(argv[0]);
+				exit(0);
+
+			default:
+				printUsage(argv[0]);
+				exit(1);
+		}
+	}
+	if (optind < argc)
+	{
+		fprintf(stderr, "%s: unexpected argument \"%s\"\n", argv[0], argv[optind]);
+		printUsage(argv[0]);
+		exit(1);
+	}
+
+	//	Walls and partitions take up to about a third of the grid, so
+	//	don't let travelers fill more than half of it.
+	unsigned long maxTravelers = (static_cast<unsigned long>(numRows) * numCols) / 2;
+	if (numTravelers > maxTravelers)
+	{
+		fprintf(stderr, "%s: a %u x %u grid can hold at most %lu travelers\n",
+				argv[0], numRows, numCols, maxTravelers);
+		exit(1);
+	}
+
+	if (engineModeList.empty())
+		engineModeList.push_back(EngineMode::MUTEX);
+	engineMode = engineModeList[0];
+
+	if (numWorkers == 0)
+		numWorkers = max(1U, thread::hardware_concurrency());
+
+	if (!haveSeed)
+	{
+		random_device randDev;
+		randomSeed = randDev();
+	}
+}
@@ -0,0 +1,216 @@
+//
+//  bench.cpp
+//  Final Project CSC412
+//
+//	Benchmark suite.  Runs a fixed list of scenarios headlessly, each for
+//	the same number of ticks, and prints the results as JSON on stdout
+//	(progress goes to stderr), so that runs of different versions can be
+//	compared.  Each scenario group varies one thing from a common baseline:
+//	grid size, traveler density, number of partitions, number of threads,
+//	and the synchronization strategy (the engines, and the grid lock
+//	granularities of the mutex engine, which also takes a per-traveler lock).
+//	The last group runs the tick engine with each version of the batched
+//	move evaluation (see moveBatch.h).
+//
+//	For each run:  moves/sec, p50 and p99 of the time a single traveler
+//	step takes, what came of the move attempts, how many partition slides
+//	were tried and succeeded, and the time the workers spent waiting for
+//	grid locks and traveler locks.
+//
+//	usage:	bench [--seed N] [--max-ticks N] [--threads N]
+//	(--threads is the largest thread count of the thread scaling group)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+//
+#include "moveBatch.h"
+#include "simulation.h"
+
+using namespace std;
+
+//	Defaults (--max-ticks and --threads override them)
+const unsigned long BENCH_NUM_TICKS = 200;
+const unsigned int BENCH_MAX_NUM_WORKERS = 8;
+
+//	Common baseline of the scenarios
+const unsigned int BASE_GRID_DIM = 300;
+const double BASE_DENSITY = 0.10;
+
+struct BenchScenario
+{
+	//	what the scenario varies, and its name within that group
+	string group;
+	string name;
+	unsigned int numRows;
+	unsigned int numCols;
+	//	travelers per grid square
+	double density;
+	//	-1 for the default number
+	int numPartitions;
+	unsigned int numWorkers;
+	EngineMode engine;
+	LockGranularity locks;
+	bool scalarMoves;
+};
+
+vector<BenchScenario> buildScenarioList(unsigned int maxNumWorkers)
+{
+	vector<BenchScenario> scenarioList;
+	const BenchScenario base = {"", "", BASE_GRID_DIM, BASE_GRID_DIM, BASE_DENSITY, -1,
+								maxNumWorkers, EngineMode::MUTEX, LockGranularity::CELL, false};
+
+	for (unsigned int dim : {100U, 300U, 1000U})
+	{
+		BenchScenario scenario = base;
+		scenario.group = "grid";
+		scenario.name = to_string(dim) + "x" + to_string(dim);
+		scenario.numRows = scenario.numCols = dim;
+		scenarioList.push_back(scenario);
+	}
+
+	for (double density : {0.01, 0.10, 0.30})
+	{
+		BenchScenario scenario = base;
+		scenario.group = "density";
+		scenario.name = to_string(static_cast<int>(density * 100 + 0.5)) + "%";
+		scenario.density = density;
+		scenarioList.push_back(scenario);
+	}
+
+	for (int numParts : {0, 150, 600})
+	{
+		BenchScenario scenario = base;
+		scenario.group = "partitions";
+		scenario.name = to_string(numParts);
+		scenario.numPartitions = numParts;
+		scenarioList.push_back(scenario);
+	}
+
+	vector<unsigned int> workerCountList;
+	for (unsigned int n=1; n<maxNumWorkers; n*=2)
+		workerCountList.push_back(n);
+	workerCountList.push_back(maxNumWorkers);
+	for (unsigned int n : workerCountList)
+	{
+		BenchScenario scenario = base;
+		scenario.group = "threads";
+		scenario.name = to_string(n);
+		scenario.numWorkers = n;
+		scenarioList.push_back(scenario);
+	}
+
+	for (int k=0; k<static_cast<int>(LockGranularity::NUM_LOCK_GRANULARITIES); k++)
+	{
+		BenchScenario scenario = base;
+		scenario.group = "sync";
+		scenario.locks = static_cast<LockGranularity>(k);
+		scenario.name = engineStr(scenario.engine) + "/" + lockStr(scenario.locks);
+		scenarioList.push_back(scenario);
+	}
+	for (int k=0; k<static_cast<int>(EngineMode::NUM_ENGINE_MODES); k++)
+	{
+		if (static_cast<EngineMode>(k) == EngineMode::MUTEX)
+			continue;
+		BenchScenario scenario = base;
+		scenario.group = "sync";
+		scenario.engine = static_cast<EngineMode>(k);
+		scenario.name = engineStr(scenario.engine);
+		scenarioList.push_back(scenario);
+	}
+
+	for (bool scalar : {false, true})
+	{
+		BenchScenario scenario = base;
+		scenario.group = "moves";
+		scenario.engine = EngineMode::TICK;
+		scenario.scalarMoves = scalar;
+		//	(runScenario() picks the evaluator, and the JSON reports the one
+		//	that actually ran)
+		scenario.name = engineStr(scenario.engine) + (scalar ? "/scalar" : "/avx2");
+		scenarioList.push_back(scenario);
+	}
+
+	return scenarioList;
+}
+
+//	Runs one scenario and prints its JSON object (without a trailing comma)
+void runScenario(const BenchScenario& scenario)
+{
+	numRows = scenario.numRows;
+	numCols = scenario.numCols;
+	numTravelers = max(1U, static_cast<unsigned int>(scenario.density * numRows * numCols));
+	numPartitions = scenario.numPartitions;
+	numWorkers = scenario.numWorkers;
+	engineMode = scenario.engine;
+	lockGranularity = scenario.locks;
+	useScalarMoves(scenario.scalarMoves);
+
+	fprintf(stderr, "%-12s %-16s", scenario.group.c_str(), scenario.name.c_str());
+
+	initializeApplication();
+	measureStepLatency = true;
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	runSimulation();
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	measureStepLatency = false;
+
+	unsigned long numMoves = numMovesDone.load();
+	double movesPerSec = elapsed > 0 ? numMoves / elapsed : 0.0;
+	fprintf(stderr, " %12.0f moves/sec\n", movesPerSec);
+
+	SimulationStats stats = getSimulationStats();
+	string outcomes;
+	for (int k=0; k<static_cast<int>(MoveOutcome::NUM_MOVE_OUTCOMES); k++)
+	{
+		outcomes += (k > 0 ? ", \"" : "\"") + outcomeStr(static_cast<MoveOutcome>(k)) + "\": " +
+					to_string(stats.outcomeCount[k]);
+	}
+
+	printf("    {\"group\": \"%s\", \"name\": \"%s\", \"rows\": %u, \"cols\": %u, "
+		   "\"travelers\": %u, \"partitions\": %zu, \"threads\": %u, \"engine\": \"%s\", \"locks\": \"%s\",\n"
+		   "     \"move_evaluator\": \"%s\",\n"
+		   "     \"ticks\": %lu, \"moves\": %lu, \"slides\": %lu, \"run_seconds\": %.6f, \"moves_per_sec\": %.0f,\n"
+		   "     \"step_latency_p50_ns\": %lu, \"step_latency_p99_ns\": %lu,\n"
+		   "     \"attempts\": %lu, \"outcomes\": {%s},\n"
+		   "     \"slide_attempts\": %lu, \"slide_successes\": %lu,"
+		   " \"lock_wait_ms\": %.3f, \"traveler_lock_wait_ms\": %.3f}",
+		   scenario.group.c_str(), scenario.name.c_str(), numRows, numCols,
+		   numTravelers, partitionList.size(), numWorkers, engineStr(engineMode).c_str(),
+		   engineMode == EngineMode::MUTEX ? lockStr(lockGranularity).c_str() : "none",
+		   engineMode == EngineMode::TICK ? moveEvaluatorName() : "none",
+		   numTicksDone.load(), numMoves, numSlidesDone.load(), elapsed, movesPerSec,
+		   static_cast<unsigned long>(stepLatency.quantile(0.50)),
+		   static_cast<unsigned long>(stepLatency.quantile(0.99)),
+		   stats.numMoveAttempts, outcomes.c_str(),
+		   stats.numSlideAttempts, stats.numSlideSuccesses,
+		   stats.gridLockWaitTime / 1e6, stats.travelerLockWaitTime / 1e6);
+
+	cleanupSimulation();
+}
+
+int main(int argc, char* argv[])
+{
+	maxNumTicks = BENCH_NUM_TICKS;
+	numWorkers = max(BENCH_MAX_NUM_WORKERS, thread::hardware_concurrency());
+	travelerSleepTime = 0;
+	parseArguments(argc, argv);
+
+	vector<BenchScenario> scenarioList = buildScenarioList(numWorkers);
+
+	printf("{\n  \"seed\": %lu,\n  \"ticks_per_run\": %lu,\n  \"hardware_threads\": %u,\n  \"results\": [\n",
+		   randomSeed, maxNumTicks, thread::hardware_concurrency());
+	for (size_t k=0; k<scenarioList.size(); k++)
+	{
+		runScenario(scenarioList[k]);
+		printf("%s\n", k+1 < scenarioList.size() ? "," : "");
+		fflush(stdout);
+	}
+	printf("  ]\n}\n");
+
+	return 0;
+}
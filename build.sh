@@ -2,24 +2,88 @@
 
 set -e
 
-build_version () {
-    echo "Building $1..."
-    cd $1
-    g++ -std=c++17 \
+#   OpenGL/glut link flags depend on the platform
+if [ "$(uname)" == "Darwin" ]; then
+    GL_LIBS="-framework OpenGL -framework GLUT"
+else
+    GL_LIBS="-lGL -lglut"
+fi
+
+ENGINE_SOURCES="simulation.cpp distanceField.cpp freeSquareMap.cpp lockManager.cpp moveBatch.cpp workerPool.cpp transport.cpp arguments.cpp utils.cpp"
+
+#   Graphic version: the simulation plus the glut front end
+build_final () {
+    echo "Building final..."
+    g++ -std=c++17 -O2 \
         main.cpp \
         gl_frontEnd.cpp \
-        utils.cpp \
+        $ENGINE_SOURCES \
         -o final \
-        -framework OpenGL \
-        -framework GLUT
-    cd ..
+        -pthread \
+        $GL_LIBS
 }
 
-build_version Version1
-build_version Version2
-build_version Version3
-build_version Version4
-build_version Version5
+#   Headless version: the simulation alone, no OpenGL/glut needed
+build_headless () {
+    echo "Building headless..."
+    g++ -std=c++17 -O2 \
+        headless.cpp \
+        $ENGINE_SOURCES \
+        -o headless \
+        -pthread
+}
 
-echo "Build complete."
+#   Stress test of the move/slide synchronization (no OpenGL/glut either)
+build_stress () {
+    echo "Building stress..."
+    g++ -std=c++17 -O2 \
+        stress.cpp \
+        $ENGINE_SOURCES \
+        -o stress \
+        -pthread
+}
+
+#   Distributed version: one process per band of rows (no OpenGL/glut)
+build_distributed () {
+    echo "Building distributed..."
+    g++ -std=c++17 -O2 \
+        distributed.cpp \
+        $ENGINE_SOURCES \
+        -o distributed \
+        -pthread
+}
 
+#   Benchmark suite, JSON results on stdout (no OpenGL/glut)
+build_bench () {
+    echo "Building bench..."
+    g++ -std=c++17 -O2 \
+        bench.cpp \
+        $ENGINE_SOURCES \
+        -o bench \
+        -pthread
+}
+
+#   Checks of the engines' building blocks against brute force (no OpenGL/glut)
+build_check () {
+    echo "Building check..."
+    g++ -std=c++17 -O2 \
+        check.cpp \
+        $ENGINE_SOURCES \
+        -o check \
+        -pthread
+}
+
+if [ $# -eq 0 ]; then
+    build_final
+    build_headless
+    build_stress
+    build_distributed
+    build_bench
+    build_check
+else
+    for target in "$@"; do
+        build_$target
+    done
+fi
+
+echo "Build complete."
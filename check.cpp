@@ -0,0 +1,476 @@
+//
+//  check.cpp
+//  Final Project CSC412
+//
+//	Checks of the pieces the engines build on, each one against a plain,
+//	obviously correct version of the same computation, on random inputs
+//	drawn from the seed.  Prints one line per check, and the exit status
+//	is 0 only if every check passed.
+//
+//	usage:	check [--seed N]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+//
+#include "arena.h"
+#include "distanceField.h"
+#include "freeSquareMap.h"
+#include "grid.h"
+#include "moveBatch.h"
+#include "randomStream.h"
+#include "simulation.h"
+#include "workerPool.h"
+
+using namespace std;
+
+//	Prints the outcome of a check, and passes it on
+bool report(const string& label, const string& problem)
+{
+	printf("%-32s %s\n", label.c_str(), problem.empty() ? "ok" : ("FAILED: " + problem).c_str());
+	return problem.empty();
+}
+
+//	Fills the grid with random square types
+void randomizeGrid(Grid& checkGrid, unsigned int rows, unsigned int cols, RandomStream& rng)
+{
+	checkGrid.allocate(rows, cols);
+	for (unsigned int row=0; row<rows; row++)
+		for (unsigned int col=0; col<cols; col++)
+			checkGrid.set(row, col, static_cast<SquareType>(
+							rng.nextBelow(static_cast<uint32_t>(SquareType::NUM_SQUARE_TYPES))));
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Batched Move Evaluation
+//-----------------------------------------------------------------------------
+#endif
+
+//	marks the target lanes an evaluator must not write to
+const uint32_t UNTOUCHED_LANE = 0xDEADBEEF;
+
+//	Random heads and directions, with the lanes at the front stepping off
+//	each edge of the grid, and a few heads that aren't even on the grid
+void fillBatch(MoveBatch& batch, size_t count, unsigned int rows, unsigned int cols, RandomStream& rng)
+{
+	const uint32_t edgeList[][3] = {
+		{0, 0, static_cast<uint32_t>(Direction::SOUTH)},
+		{rows - 1, cols - 1, static_cast<uint32_t>(Direction::NORTH)},
+		{rows / 2, 0, static_cast<uint32_t>(Direction::EAST)},
+		{rows / 2, cols - 1, static_cast<uint32_t>(Direction::WEST)},
+		{rows + 3, 0, static_cast<uint32_t>(Direction::NORTH)},
+		{0, cols + 3, static_cast<uint32_t>(Direction::WEST)},
+		{rows - 1, cols - 1, static_cast<uint32_t>(Direction::SOUTH)},
+		//	the last square of the grid, right before the read padding
+		{rows - 2, cols - 1, static_cast<uint32_t>(Direction::NORTH)},
+		{rows, 0, static_cast<uint32_t>(Direction::SOUTH)}
+	};
+	const size_t numEdges = sizeof(edgeList) / sizeof(edgeList[0]);
+
+	batch.count = count;
+	for (size_t k=0; k<MoveBatch::CAPACITY; k++)
+	{
+		batch.id[k] = static_cast<uint32_t>(k);
+		if (k < numEdges)
+		{
+			batch.row[k] = edgeList[k][0];
+			batch.col[k] = edgeList[k][1];
+			batch.dir[k] = edgeList[k][2];
+		}
+		else
+		{
+			batch.row[k] = rng.nextBelow(rows);
+			batch.col[k] = rng.nextBelow(cols);
+			batch.dir[k] = rng.nextBelow(static_cast<uint32_t>(Direction::NUM_DIRECTIONS));
+		}
+		batch.targetRow[k] = batch.targetCol[k] = batch.targetSquare[k] = UNTOUCHED_LANE;
+	}
+}
+
+//	What the first mismatch between two evaluated batches is, if any
+string compareBatches(const MoveBatch& a, const MoveBatch& b)
+{
+	for (size_t k=0; k<MoveBatch::CAPACITY; k++)
+	{
+		if (a.targetRow[k] != b.targetRow[k] || a.targetCol[k] != b.targetCol[k] ||
+			a.targetSquare[k] != b.targetSquare[k])
+		{
+			return "lane " + to_string(k) + " of " + to_string(a.count) + ": (" +
+				   to_string(a.targetRow[k]) + ", " + to_string(a.targetCol[k]) + ") " +
+				   to_string(a.targetSquare[k]) + " vs (" +
+				   to_string(b.targetRow[k]) + ", " + to_string(b.targetCol[k]) + ") " +
+				   to_string(b.targetSquare[k]);
+		}
+	}
+	return "";
+}
+
+//	The scalar and AVX2 evaluators against each other, and the scalar one
+//	against the grid itself, for batch sizes on and off a multiple of 8
+bool checkMoveEvaluators(void)
+{
+	RandomStream rng(randomSeed, 21);
+	Grid checkGrid;
+	//	sides that aren't multiples of 8, so rows start anywhere in a vector
+	const unsigned int rows = 37, cols = 53;
+	randomizeGrid(checkGrid, rows, cols, rng);
+
+	static MoveBatch scalarBatch, vectorBatch;
+	string problem;
+	bool hasVector = true;
+	for (size_t count : {size_t(1), size_t(7), size_t(8), size_t(13), size_t(64), size_t(203),
+						 MoveBatch::CAPACITY - 1, MoveBatch::CAPACITY})
+	{
+		for (int trial=0; trial<20 && problem.empty(); trial++)
+		{
+			fillBatch(scalarBatch, count, rows, cols, rng);
+			vectorBatch = scalarBatch;
+
+			useScalarMoves(true);
+			evaluateMoves(scalarBatch, checkGrid.squareBytes(), rows, cols);
+			useScalarMoves(false);
+			hasVector = string(moveEvaluatorName()) != "scalar";
+			evaluateMoves(vectorBatch, checkGrid.squareBytes(), rows, cols);
+
+			for (size_t k=0; k<MoveBatch::CAPACITY && problem.empty(); k++)
+			{
+				uint32_t row = scalarBatch.row[k] + DIRECTION_ROW_STEP[scalarBatch.dir[k]];
+				uint32_t col = scalarBatch.col[k] + DIRECTION_COL_STEP[scalarBatch.dir[k]];
+				uint32_t square = (row < rows && col < cols)
+									? static_cast<uint32_t>(checkGrid.get(row, col))
+									: OFF_GRID;
+				if (k >= count)
+					row = col = square = UNTOUCHED_LANE;
+				if (scalarBatch.targetRow[k] != row || scalarBatch.targetCol[k] != col ||
+					scalarBatch.targetSquare[k] != square)
+					problem = "scalar lane " + to_string(k) + " of " + to_string(count) +
+							  " disagrees with the grid";
+			}
+			if (problem.empty())
+				problem = compareBatches(scalarBatch, vectorBatch);
+		}
+	}
+
+	return report(hasVector ? "moves scalar/avx2" : "moves scalar (no avx2 here)", problem);
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Distance Field Repair
+//-----------------------------------------------------------------------------
+#endif
+
+//	Small partitions on a small grid with walls, so that the slides keep
+//	opening and closing the ways to the exit
+const unsigned int REPAIR_NUM_ROWS = 19;
+const unsigned int REPAIR_NUM_COLS = 23;
+const unsigned int REPAIR_NUM_PARTITIONS = 12;
+const unsigned int REPAIR_NUM_TRIALS = 40;
+const unsigned int REPAIR_NUM_SLIDES = 150;
+
+struct CheckPartition
+{
+	bool isVertical;
+	ArenaArray<GridPosition> blockList;
+};
+
+//	Slides the whole partition one square across its length, the way the
+//	simulation's do:  only if every square its blocks move into is free,
+//	so a whole line of obstacles shifts sideways and the line it leaves
+//	opens up.  Then notes the slide.
+//	@return true if it slid
+bool slideCheckPartition(Grid& checkGrid, CheckPartition& part, int step, DistanceField& field)
+{
+	int dr = part.isVertical ? 0 : step;
+	int dc = part.isVertical ? step : 0;
+	for (const GridPosition& pos : part.blockList)
+	{
+		//	a step off row or column 0 wraps around to a huge unsigned value
+		unsigned int row = pos.row + dr, col = pos.col + dc;
+		if (row >= checkGrid.numRows() || col >= checkGrid.numCols() ||
+			checkGrid.get(row, col) != SquareType::FREE_SQUARE)
+			return false;
+	}
+
+	SquareType partType = part.isVertical ? SquareType::VERTICAL_PARTITION
+										  : SquareType::HORIZONTAL_PARTITION;
+	for (const GridPosition& pos : part.blockList)
+		checkGrid.set(pos.row, pos.col, SquareType::FREE_SQUARE);
+	for (GridPosition& pos : part.blockList)
+	{
+		pos.row += dr;
+		pos.col += dc;
+		checkGrid.set(pos.row, pos.col, partType);
+	}
+	field.noteSlide(part.blockList, dr, dc);
+	return true;
+}
+
+//	What the first square whose distance differs is, if any
+string compareFields(const DistanceField& repaired, const DistanceField& fresh,
+					 unsigned int rows, unsigned int cols)
+{
+	for (unsigned int row=0; row<rows; row++)
+		for (unsigned int col=0; col<cols; col++)
+			if (repaired.distance(row, col) != fresh.distance(row, col))
+				return "(" + to_string(row) + ", " + to_string(col) + ") repaired to " +
+					   to_string(repaired.distance(row, col)) + ", " +
+					   to_string(fresh.distance(row, col)) + " from scratch";
+	return "";
+}
+
+//	Random slide sequences:  after each slide (or, now and then, a few
+//	slides noted in a row), the repaired field must be the one a search
+//	from scratch finds on the same grid
+bool checkDistanceRepair(void)
+{
+	RandomStream rng(randomSeed, 23);
+	WorkerPool pool(3);
+	const unsigned int rows = REPAIR_NUM_ROWS, cols = REPAIR_NUM_COLS;
+	string problem;
+	size_t numSlides = 0;
+
+	for (unsigned int trial=0; trial<REPAIR_NUM_TRIALS && problem.empty(); trial++)
+	{
+		Grid checkGrid;
+		checkGrid.allocate(rows, cols);
+		for (unsigned int row=0; row<rows; row++)
+			for (unsigned int col=0; col<cols; col++)
+				if (rng.nextBelow(5) == 0)
+					checkGrid.set(row, col, SquareType::WALL);
+		GridPosition exitPos = {rng.nextBelow(rows), rng.nextBelow(cols)};
+		checkGrid.set(exitPos.row, exitPos.col, SquareType::EXIT);
+
+		Arena partArena;
+		vector<CheckPartition> partList;
+		for (unsigned int p=0; p<REPAIR_NUM_PARTITIONS; p++)
+		{
+			CheckPartition part;
+			part.isVertical = rng.nextBelow(2) == 0;
+			unsigned int length = 2 + rng.nextBelow(4);
+			unsigned int row = rng.nextBelow(rows - (part.isVertical ? length : 0));
+			unsigned int col = rng.nextBelow(cols - (part.isVertical ? 0 : length));
+			bool isClear = true;
+			for (unsigned int k=0; k<length; k++)
+				isClear &= checkGrid.get(row + (part.isVertical ? k : 0),
+										 col + (part.isVertical ? 0 : k)) == SquareType::FREE_SQUARE;
+			if (!isClear)
+				continue;
+
+			part.blockList = partArena.createArray<GridPosition>(length);
+			for (unsigned int k=0; k<length; k++)
+			{
+				part.blockList[k] = {row + (part.isVertical ? k : 0), col + (part.isVertical ? 0 : k)};
+				checkGrid.set(part.blockList[k].row, part.blockList[k].col,
+							  part.isVertical ? SquareType::VERTICAL_PARTITION
+											  : SquareType::HORIZONTAL_PARTITION);
+			}
+			partList.push_back(part);
+		}
+		if (partList.empty())
+			continue;
+
+		DistanceField repaired;
+		repaired.compute(checkGrid, exitPos, pool);
+		for (unsigned int s=0; s<REPAIR_NUM_SLIDES && problem.empty(); s++)
+		{
+			unsigned int numNoted = (rng.nextBelow(4) == 0) ? 2 + rng.nextBelow(3) : 1;
+			for (unsigned int k=0; k<numNoted; k++)
+				numSlides += slideCheckPartition(checkGrid, partList[rng.nextBelow(static_cast<uint32_t>(partList.size()))],
+												 rng.nextBelow(2) ? 1 : -1, repaired);
+			repaired.repair(checkGrid);
+
+			DistanceField fresh;
+			fresh.compute(checkGrid, exitPos, pool);
+			problem = compareFields(repaired, fresh, rows, cols);
+			if (!problem.empty())
+				problem = "trial " + to_string(trial) + ", step " + to_string(s) + ": " + problem;
+		}
+	}
+
+	if (problem.empty() && numSlides == 0)
+		problem = "no partition ever slid";
+	return report("distance repair (" + to_string(numSlides) + " slides)", problem);
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Free-square Map
+//-----------------------------------------------------------------------------
+#endif
+
+//	What the first query that disagrees with a scan of the grid is, if any.
+//	Every square gets its rank and its free neighbors checked, every free
+//	square its select(), and the random ranges (starting and ending
+//	anywhere in a word) all their selectInRange() ranks.
+string compareFreeSquares(const FreeSquareMap& freeMap, const Grid& checkGrid, RandomStream& rng)
+{
+	const unsigned int rows = checkGrid.numRows(), cols = checkGrid.numCols();
+	const size_t numSquares = checkGrid.size();
+	vector<size_t> freeList;
+	for (size_t index=0; index<numSquares; index++)
+		if (checkGrid.get(static_cast<unsigned int>(index / cols), static_cast<unsigned int>(index % cols)) ==
+			SquareType::FREE_SQUARE)
+			freeList.push_back(index);
+
+	if (freeMap.count() != freeList.size())
+		return "count " + to_string(freeMap.count()) + " instead of " + to_string(freeList.size());
+
+	size_t numBefore = 0;
+	for (size_t index=0; index<=numSquares; index++)
+	{
+		if (freeMap.rank(index) != numBefore)
+			return "rank(" + to_string(index) + ") is " + to_string(freeMap.rank(index)) +
+				   " instead of " + to_string(numBefore);
+		if (index == numSquares)
+			break;
+
+		unsigned int row = static_cast<unsigned int>(index / cols);
+		unsigned int col = static_cast<unsigned int>(index % cols);
+		bool isFree = checkGrid.get(row, col) == SquareType::FREE_SQUARE;
+		if (freeMap.isFree(index) != isFree)
+			return "square " + to_string(index) + " is " + (isFree ? "free" : "taken") + " but not in the map";
+		numBefore += isFree;
+
+		unsigned int mask = 0;
+		for (int d=0; d<static_cast<int>(Direction::NUM_DIRECTIONS); d++)
+		{
+			int nr = static_cast<int>(row) + DIRECTION_ROW_STEP[d];
+			int nc = static_cast<int>(col) + DIRECTION_COL_STEP[d];
+			if (nr >= 0 && nr < static_cast<int>(rows) && nc >= 0 && nc < static_cast<int>(cols) &&
+				checkGrid.get(nr, nc) == SquareType::FREE_SQUARE)
+				mask |= 1U << d;
+		}
+		if (freeMap.freeNeighbors(row, col) != mask)
+			return "freeNeighbors(" + to_string(row) + ", " + to_string(col) + ") is " +
+				   to_string(freeMap.freeNeighbors(row, col)) + " instead of " + to_string(mask);
+	}
+
+	//	(down to select(count()-1), the last free square)
+	for (size_t k=0; k<freeList.size(); k++)
+		if (freeMap.select(k) != freeList[k])
+			return "select(" + to_string(k) + ") is " + to_string(freeMap.select(k)) +
+				   " instead of " + to_string(freeList[k]);
+
+	for (int r=0; r<200; r++)
+	{
+		size_t first = rng.nextBelow(static_cast<uint32_t>(numSquares + 1));
+		size_t last = first + rng.nextBelow(static_cast<uint32_t>(numSquares - first + 1));
+		vector<size_t> rangeList;
+		for (size_t index : freeList)
+			if (index >= first && index < last)
+				rangeList.push_back(index);
+
+		string range = "[" + to_string(first) + ", " + to_string(last) + ")";
+		if (freeMap.countRange(first, last) != rangeList.size())
+			return "countRange" + range + " is " + to_string(freeMap.countRange(first, last)) +
+				   " instead of " + to_string(rangeList.size());
+		for (size_t k=0; k<=rangeList.size(); k++)
+		{
+			size_t expected = (k < rangeList.size()) ? rangeList[k] : last;
+			if (freeMap.selectInRange(first, last, k) != expected)
+				return "selectInRange" + range + "(" + to_string(k) + ") is " +
+					   to_string(freeMap.selectInRange(first, last, k)) + " instead of " + to_string(expected);
+		}
+	}
+	return "";
+}
+
+//	Grids whose sizes end partway through a word and partway through a
+//	block, with block counts on and off a power of two (12 x 12:  3 words,
+//	1 block;  32 x 32:  exactly 2 blocks;  37 x 53:  4 blocks;  45 x 61:
+//	6 blocks;  130 x 129:  33 blocks), emptier and fuller.  Each map gets
+//	checked as built, after markTaken() on some squares, and after the
+//	workers of a pool clearSquare() some more and recount().
+bool checkFreeSquareMap(void)
+{
+	RandomStream rng(randomSeed, 25);
+	WorkerPool pool(3);
+	const unsigned int shapeList[][2] = {{12, 12}, {32, 32}, {37, 53}, {45, 61}, {130, 129}};
+	string problem;
+
+	for (const auto& shape : shapeList)
+	{
+		for (unsigned int takenPercent : {5U, 50U, 95U})
+		{
+			if (!problem.empty())
+				break;
+			const unsigned int rows = shape[0], cols = shape[1];
+			string label = to_string(rows) + " x " + to_string(cols) + ", " + to_string(takenPercent) + "% taken";
+
+			Grid checkGrid;
+			checkGrid.allocate(rows, cols);
+			for (unsigned int row=0; row<rows; row++)
+				for (unsigned int col=0; col<cols; col++)
+					if (rng.nextBelow(100) < takenPercent)
+						checkGrid.set(row, col, rng.nextBelow(2) ? SquareType::WALL : SquareType::TRAVELER);
+			//	and always take the last square, the one select(count()-1)
+			//	would find if the partial block were miscounted
+			checkGrid.set(rows - 1, cols - 1, SquareType::WALL);
+
+			FreeSquareMap freeMap;
+			freeMap.build(checkGrid, pool);
+			problem = compareFreeSquares(freeMap, checkGrid, rng);
+			if (!problem.empty())
+			{
+				problem = label + ", built: " + problem;
+				break;
+			}
+
+			for (size_t n=checkGrid.size()/10; n>0; n--)
+			{
+				size_t index = rng.nextBelow(static_cast<uint32_t>(checkGrid.size()));
+				checkGrid.set(static_cast<unsigned int>(index / cols), static_cast<unsigned int>(index % cols),
+							  SquareType::TRAVELER);
+				freeMap.markTaken(index);
+			}
+			problem = compareFreeSquares(freeMap, checkGrid, rng);
+			if (!problem.empty())
+			{
+				problem = label + ", after markTaken: " + problem;
+				break;
+			}
+
+			//	each worker takes squares in its own band of rows, then the
+			//	counts get rebuilt
+			const unsigned int numWorkersInPool = pool.size();
+			pool.run([&](unsigned int workerIndex) {
+				RandomStream workerRng(randomSeed, 250 + workerIndex);
+				size_t first = checkGrid.size() * workerIndex / numWorkersInPool;
+				size_t last = checkGrid.size() * (workerIndex + 1) / numWorkersInPool;
+				for (size_t n=(last - first)/5; n>0; n--)
+				{
+					size_t index = first + workerRng.nextBelow(static_cast<uint32_t>(last - first));
+					checkGrid.set(static_cast<unsigned int>(index / cols), static_cast<unsigned int>(index % cols),
+								  SquareType::TRAVELER);
+					freeMap.clearSquare(index);
+				}
+			});
+			freeMap.recount(pool);
+			problem = compareFreeSquares(freeMap, checkGrid, rng);
+			if (!problem.empty())
+				problem = label + ", after clearSquare and recount: " + problem;
+		}
+	}
+
+	return report("free-square map", problem);
+}
+
+int main(int argc, char* argv[])
+{
+	parseArguments(argc, argv);
+	printf("seed %lu\n\n", randomSeed);
+
+	bool allOk = true;
+	allOk &= checkMoveEvaluators();
+	allOk &= checkDistanceRepair();
+	allOk &= checkFreeSquareMap();
+
+	printf("\n%s\n", allOk ? "PASSED" : "FAILED");
+	return allOk ? 0 : 1;
+}
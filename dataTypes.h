@@ -7,11 +7,13 @@
 
 #ifndef DATAS_TYPES_H
 #define DATAS_TYPES_H
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <mutex>
-#include <OpenGL/gl.h>
-#include <vector>
 #include <string>
+#include "arena.h"
+#include "randomStream.h"
 
 /**	Travel Direction data type.
  *	Note that if you define a variable
@@ -29,10 +31,18 @@ enum class Direction
 	NUM_DIRECTIONS
 };
 
+//	Row and column steps of a move in each direction (NORTH, WEST, SOUTH, EAST)
+const int DIRECTION_ROW_STEP[4] = {1, 0, -1, 0};
+const int DIRECTION_COL_STEP[4] = {0, 1, 0, -1};
+
+inline int rowStep(Direction dir) { return DIRECTION_ROW_STEP[static_cast<int>(dir)]; }
+inline int colStep(Direction dir) { return DIRECTION_COL_STEP[static_cast<int>(dir)]; }
+
 
-/**	Grid square types for this simulation
+/**	Grid square types for this simulation.
+ *	Stored on a single byte, since the grid holds one per square.
  */
-enum class SquareType
+enum class SquareType : uint8_t
 {
 	FREE_SQUARE,
 	EXIT,
@@ -45,6 +55,96 @@ enum class SquareType
 
 };
 
+/**	How the travelers' moves get synchronized
+ */
+enum class EngineMode
+{
+	//	per-traveler mutex plus one mutex per grid square (the V5 scheme)
+	MUTEX,
+	//	no locks on the move path:  squares are claimed with compare-and-swap
+	CAS,
+	//	synchronous ticks:  moves are proposed, then committed all at once (deterministic)
+	TICK,
+	//	each worker owns a band of rows;  only moves across bands are synchronized
+	REGION,
+	//
+	NUM_ENGINE_MODES
+};
+
+/**	How the processes of a distributed run talk to each other
+ */
+enum class TransportMode
+{
+	//	mailboxes in a block of memory shared by the processes (one host)
+	SHARED_MEMORY,
+	//	TCP connections (stands in for a cluster interconnect)
+	TCP,
+	//
+	NUM_TRANSPORT_MODES
+};
+
+/**	How the travelers pick the direction of their next move
+ */
+enum class RoutingMode
+{
+	//	uniformly at random (a random walk)
+	RANDOM,
+	//	down the distance-to-exit field, with a few random moves (epsilon-greedy)
+	GRADIENT,
+	//
+	NUM_ROUTING_MODES
+};
+
+/**	How the walls, partitions, and travelers get placed at startup
+ */
+enum class MazeMode
+{
+	//	over the whole grid, one wall at a time, from the seeded engine
+	CLASSIC,
+	//	tile by tile, each tile on any worker with its own random stream
+	TILED,
+	//
+	NUM_MAZE_MODES
+};
+
+/**	How many grid squares share a lock (mutex engine only)
+ */
+enum class LockGranularity
+{
+	//	one lock per square
+	CELL,
+	//	one lock per tile of tileSize x tileSize squares
+	TILE,
+	//	a fixed number of locks, squares are hashed to one of them
+	STRIPE,
+	//	one lock for the whole grid
+	GLOBAL,
+	//
+	NUM_LOCK_GRANULARITIES
+};
+
+/**	What came of one traveler's attempt to move its head
+ */
+enum class MoveOutcome
+{
+	//	the head moved (into a free square, or by pushing a partition)
+	MOVED,
+	//	the target square is outside the grid
+	OUT_OF_BOUNDS,
+	//	the target square is a wall
+	WALL,
+	//	the target square holds a traveler segment
+	TRAVELER,
+	//	the target square is a partition that couldn't slide out of the way
+	PARTITION_BLOCKED,
+	//	another worker changed the target square first
+	LOST_RACE,
+	//	the target square is the exit:  the traveler starts fading out
+	EXIT,
+	//
+	NUM_MOVE_OUTCOMES
+};
+
 /**	Data type to store the position of *things* on the grid
  */
 struct GridPosition
@@ -77,26 +177,34 @@ struct TravelerSegment
 
 
 /**
- *	Data type for storing all information about a traveler
- *	Feel free to add anything you need.
+ *	Where a traveler is in its life (the travelers themselves are stored
+ *	as a structure of arrays, see TravelerStore)
  */
-struct Traveler
+enum class TravelerState : uint8_t
 {
-    unsigned int index;
-    GLfloat rgba[4];
-	std::vector<TravelerSegment> segmentList;
-	// added mutex so each traveler protects its own data
-	// this is used in V4 as a per traveler locking
-	std::mutex travelerMutex;
-
+	//	moving around the grid
+	ACTIVE,
+	//	the head reached the exit:  the traveler fades out, one segment per step
+	EXITING,
+	//	the last segment has left the grid (set under the global mutex)
+	DONE
 };
 
 
+/**	Partition index value for squares that hold no partition
+ */
+const uint16_t NO_PARTITION = 0xFFFF;
+
 /**
  *	Data type to represent a sliding partition
  */
 struct SlidingPartition
 {
+	/*	index in the partition list (also what the square-to-partition
+	 *	index stores for each of its blocks)
+	 */
+	uint16_t index;
+
 	/*	vertical vs. horizontal partition
 	 */
 	bool isVertical;
@@ -104,11 +212,65 @@ struct SlidingPartition
 	/**	The blocks making up the partition, listed
 	 *		top-to-bottom for a vertical list
 	 *		left-to-right for a horizontal list
+	 *	(in the simulation's arena, like the partition itself)
+	 */
+	ArenaArray<GridPosition> blockList;
+
+	/**	Protects blockList in the mutex engine
+	 */
+	std::mutex blockListMutex;
+
+	/**	Set while a lock-free slide is in progress, so that two travelers
+	 *	cannot push the same partition at the same time
 	 */
-	std::vector<GridPosition> blockList;
+	std::atomic<bool> isSliding{false};
 
 };
 
+/**	A traveler, as it appears in a frame snapshot
+ */
+struct TravelerFrame
+{
+	float rgba[4];
+	/**	its segments are segmentList[firstSegment .. firstSegment+numSegments-1]
+	 *	of the snapshot, head first
+	 */
+	unsigned int firstSegment;
+	unsigned int numSegments;
+};
+
+/**	Copy of everything the renderer draws, taken between two ticks, so
+ *	that it is consistent and the renderer never reads the live state
+ */
+struct FrameSnapshot
+{
+	/**	frames are numbered from 1, in the order they get published
+	 */
+	unsigned long sequence = 0;
+	/**	dirtyTileList lists the tiles that changed since frame number
+	 *	baseSequence (0:  all of them are listed)
+	 */
+	unsigned long baseSequence = 0;
+	unsigned long tick = 0;
+	unsigned int numRows = 0;
+	unsigned int numCols = 0;
+	unsigned int numTravelersDone = 0;
+	unsigned int numLiveThreads = 0;
+	/**	the grid squares, in row-major order
+	 */
+	std::vector<SquareType> squareList;
+	/**	the grid is cut into tiles of 2^tileShift x 2^tileShift squares,
+	 *	tileCols of them per row of tiles, numbered in row-major order
+	 */
+	unsigned int tileShift = 0;
+	unsigned int tileCols = 0;
+	std::vector<uint32_t> dirtyTileList;
+	/**	the travelers still on the grid
+	 */
+	std::vector<TravelerFrame> travelerList;
+	std::vector<TravelerSegment> segmentList;
+};
+
 /**	Ugly little function to return a direction as a string
 *	@param dir the direction
 *	@return the direction in readable string form
@@ -121,5 +283,48 @@ std::string dirStr(const Direction& dir);
 */
 std::string typeStr(const SquareType& type);
 
+/**	Ugly little function to return an engine mode as a string
+*	@param mode the engine mode
+*	@return the name of the mode, as given on the command line
+*/
+std::string engineStr(const EngineMode& mode);
+
+/**	Ugly little function to return a lock granularity as a string
+*	@param granularity the lock granularity
+*	@return the name of the granularity, as given on the command line
+*/
+std::string lockStr(const LockGranularity& granularity);
+
+/**	Ugly little function to return a transport as a string
+*	@param mode the transport
+*	@return the name of the transport, as given on the command line
+*/
+std::string transportStr(const TransportMode& mode);
+
+/**	Ugly little function to return a routing mode as a string
+*	@param mode the routing mode
+*	@return the name of the mode, as given on the command line
+*/
+std::string routingStr(const RoutingMode& mode);
+
+/**	Ugly little function to return a maze mode as a string
+*	@param mode the maze mode
+*	@return the name of the mode, as given on the command line
+*/
+std::string mazeStr(const MazeMode& mode);
+
+/**	Ugly little function to return a move outcome as a string
+*	@param outcome the move outcome
+*	@return the name of the outcome, in lower case
+*/
+std::string outcomeStr(const MoveOutcome& outcome);
+
+/**	Assigns a unique color to each traveler, evenly spread along the hue circle
+*	@param numTravelers the number of colors to produce
+*	@param arena where the colors get allocated
+*	@return an array of numTravelers RGBA colors
+*/
+float** createTravelerColors(unsigned int numTravelers, Arena& arena);
+
 
 #endif //	DATAS_TYPES_H
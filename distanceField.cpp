@@ -0,0 +1,265 @@
+//
+//  distanceField.cpp
+//  Final Project CSC412
+//
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+//
+#include "distanceField.h"
+#include "workerPool.h"
+
+using namespace std;
+
+//	distance, then square index:  a queue of these serves the closest first
+typedef pair<uint32_t, uint32_t> QueueEntry;
+typedef priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry> > DistanceQueue;
+
+//	Travelers get out of the way, walls and partitions don't
+static bool isObstacle(SquareType type)
+{
+	return type == SquareType::WALL || type == SquareType::VERTICAL_PARTITION ||
+		   type == SquareType::HORIZONTAL_PARTITION;
+}
+
+void DistanceField::compute(const Grid& grid, const GridPosition& exitPos, WorkerPool& pool)
+{
+	rows = grid.numRows();
+	cols = grid.numCols();
+	distanceList.reset(new atomic<uint32_t>[grid.size()]);
+	obstacleList.assign(grid.size(), 0);
+	for (size_t k=0; k<grid.size(); k++)
+	{
+		distanceList[k].store(UNREACHABLE, memory_order_relaxed);
+		obstacleList[k] = isObstacle(grid.get(static_cast<unsigned int>(k / cols),
+											  static_cast<unsigned int>(k % cols)));
+	}
+	changedList.clear();
+
+	//	Level-synchronous search:  each worker expands its share of the
+	//	current level, claiming the squares it discovers with a
+	//	compare-and-swap (so each square is discovered exactly once), and the
+	//	last one to reach the barrier gathers the next level.  The distances
+	//	don't depend on which worker got a square first.
+	const unsigned int numWorkersInPool = pool.size();
+	vector<uint32_t> frontier(1, static_cast<uint32_t>(grid.index(exitPos.row, exitPos.col)));
+	vector<vector<uint32_t> > nextList(numWorkersInPool);
+	distanceList[frontier[0]].store(0, memory_order_relaxed);
+	uint32_t level = 0;
+	Barrier levelBarrier(numWorkersInPool);
+
+	pool.run([&](unsigned int workerIndex) {
+		while (!frontier.empty())
+		{
+			vector<uint32_t>& next = nextList[workerIndex];
+			next.clear();
+			size_t first = frontier.size() * workerIndex / numWorkersInPool;
+			size_t last = frontier.size() * (workerIndex + 1) / numWorkersInPool;
+			for (size_t k=first; k<last; k++)
+			{
+				unsigned int row = frontier[k] / cols;
+				unsigned int col = frontier[k] % cols;
+				for (int d=0; d<static_cast<int>(Direction::NUM_DIRECTIONS); d++)
+				{
+					//	a step off row or column 0 wraps around to a huge unsigned value
+					unsigned int nr = row + DIRECTION_ROW_STEP[d];
+					unsigned int nc = col + DIRECTION_COL_STEP[d];
+					if (nr >= rows || nc >= cols)
+						continue;
+
+					uint32_t unseen = UNREACHABLE;
+					size_t index = grid.index(nr, nc);
+					if (!obstacleList[index] &&
+						distanceList[index].compare_exchange_strong(unseen, level + 1, memory_order_relaxed))
+						next.push_back(static_cast<uint32_t>(index));
+				}
+			}
+
+			levelBarrier.arriveAndWait([&]{
+				frontier.clear();
+				for (auto& workerNext : nextList)
+					frontier.insert(frontier.end(), workerNext.begin(), workerNext.end());
+				level++;
+			});
+		}
+	});
+}
+
+void DistanceField::noteSlide(const ArenaArray<GridPosition>& blockList, int dr, int dc)
+{
+	lock_guard<mutex> lock(changedMutex);
+	for (const GridPosition& pos : blockList)
+	{
+		changedList.push_back(pos.row * cols + pos.col);
+		changedList.push_back((pos.row - dr) * cols + (pos.col - dc));
+	}
+}
+
+//	Whether a neighbor of square index is at distance d
+bool DistanceField::hasNeighborAt(size_t index, uint32_t d) const
+{
+	unsigned int row = static_cast<unsigned int>(index / cols);
+	unsigned int col = static_cast<unsigned int>(index % cols);
+	for (int k=0; k<static_cast<int>(Direction::NUM_DIRECTIONS); k++)
+	{
+		unsigned int nr = row + DIRECTION_ROW_STEP[k];
+		unsigned int nc = col + DIRECTION_COL_STEP[k];
+		if (nr < rows && nc < cols && distance(nr, nc) == d)
+			return true;
+	}
+	return false;
+}
+
+//	Smallest distance among the neighbors of square index
+uint32_t DistanceField::closestNeighbor(size_t index) const
+{
+	unsigned int row = static_cast<unsigned int>(index / cols);
+	unsigned int col = static_cast<unsigned int>(index % cols);
+	uint32_t closest = UNREACHABLE;
+	for (int k=0; k<static_cast<int>(Direction::NUM_DIRECTIONS); k++)
+	{
+		unsigned int nr = row + DIRECTION_ROW_STEP[k];
+		unsigned int nc = col + DIRECTION_COL_STEP[k];
+		if (nr < rows && nc < cols)
+			closest = min(closest, distance(nr, nc));
+	}
+	return closest;
+}
+
+//	Three passes, each one only over squares reached from the changed ones:
+//		1.	the squares a partition moved into become obstacles and lose
+//			their distance;
+//		2.	the squares at distance d+1 from a square that lost its
+//			distance d lose theirs too, unless another neighbor at distance
+//			d still supports them.  Taking the candidates closest first
+//			means all the losses at d are known when those at d+1 get
+//			decided;
+//		3.	the squares that lost their distance, and the ones a partition
+//			left, take the best distance their neighbors offer, and the
+//			improvements spread outwards as in Dijkstra's algorithm.
+//	The result is the same as a search from scratch, whatever the order
+//	the changes were noted in.
+size_t DistanceField::repair(const Grid& grid)
+{
+	DistanceQueue queue;
+	vector<uint32_t> reopenList;
+	size_t numVisited = 0;
+
+	//	a square at distance d feeds its neighbors at d+1
+	auto queueDependents = [&](uint32_t index, uint32_t d) {
+		unsigned int row = index / cols;
+		unsigned int col = index % cols;
+		for (int k=0; k<static_cast<int>(Direction::NUM_DIRECTIONS); k++)
+		{
+			unsigned int nr = row + DIRECTION_ROW_STEP[k];
+			unsigned int nc = col + DIRECTION_COL_STEP[k];
+			if (nr < rows && nc < cols && distance(nr, nc) == d + 1)
+				queue.push({d + 1, nr * cols + nc});
+		}
+	};
+
+	//	1.	obstacles that appeared or went away
+	for (uint32_t index : changedList)
+	{
+		uint8_t isBlocked = isObstacle(grid.get(index / cols, index % cols));
+		if (isBlocked == obstacleList[index])
+			continue;
+
+		obstacleList[index] = isBlocked;
+		numVisited++;
+		if (isBlocked)
+		{
+			uint32_t d = distanceAt(index);
+			setDistance(index, UNREACHABLE);
+			if (d != UNREACHABLE)
+				queueDependents(index, d);
+		}
+		else
+			reopenList.push_back(index);
+	}
+	changedList.clear();
+
+	//	2.	squares left without a way down
+	while (!queue.empty())
+	{
+		QueueEntry entry = queue.top();
+		queue.pop();
+		uint32_t d = entry.first, index = entry.second;
+		//	already lost through another neighbor
+		if (distanceAt(index) != d)
+			continue;
+
+		numVisited++;
+		if (!hasNeighborAt(index, d - 1))
+		{
+			setDistance(index, UNREACHABLE);
+			reopenList.push_back(index);
+			queueDependents(index, d);
+		}
+	}
+
+	//	3.	new distances for the squares that lost theirs or were freed
+	for (uint32_t index : reopenList)
+	{
+		uint32_t closest = closestNeighbor(index);
+		if (closest != UNREACHABLE && closest + 1 < distanceAt(index))
+		{
+			setDistance(index, closest + 1);
+			queue.push({closest + 1, index});
+		}
+	}
+	while (!queue.empty())
+	{
+		QueueEntry entry = queue.top();
+		queue.pop();
+		uint32_t d = entry.first, index = entry.second;
+		if (distanceAt(index) != d)
+			continue;
+
+		numVisited++;
+		unsigned int row = index / cols;
+		unsigned int col = index % cols;
+		for (int k=0; k<static_cast<int>(Direction::NUM_DIRECTIONS); k++)
+		{
+			unsigned int nr = row + DIRECTION_ROW_STEP[k];
+			unsigned int nc = col + DIRECTION_COL_STEP[k];
+			size_t neighbor = static_cast<size_t>(nr) * cols + nc;
+			if (nr < rows && nc < cols && !obstacleList[neighbor] && d + 1 < distanceAt(neighbor))
+			{
+				setDistance(neighbor, d + 1);
+				queue.push({d + 1, static_cast<uint32_t>(neighbor)});
+			}
+		}
+	}
+
+	return numVisited;
+}
+
+void DistanceField::release()
+{
+	distanceList.reset();
+	obstacleList.clear();
+	changedList.clear();
+	rows = cols = 0;
+}
+
+Direction DistanceField::downhill(unsigned int row, unsigned int col, RandomStream& rng) const
+{
+	uint32_t here = distance(row, col);
+	Direction candidateList[static_cast<int>(Direction::NUM_DIRECTIONS)];
+	unsigned int numCandidates = 0;
+
+	for (int d=0; d<static_cast<int>(Direction::NUM_DIRECTIONS); d++)
+	{
+		unsigned int nr = row + DIRECTION_ROW_STEP[d];
+		unsigned int nc = col + DIRECTION_COL_STEP[d];
+		if (nr < rows && nc < cols && distance(nr, nc) < here)
+			candidateList[numCandidates++] = static_cast<Direction>(d);
+	}
+
+	if (numCandidates == 0)
+		return Direction::NUM_DIRECTIONS;
+	return (numCandidates == 1) ? candidateList[0] : candidateList[rng.nextBelow(numCandidates)];
+}
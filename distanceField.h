@@ -0,0 +1,99 @@
+//
+//  distanceField.h
+//  Final Project CSC412
+//
+//	Distance, in moves, from every square of the grid to the exit, going
+//	around the walls and the partitions (travelers move out of the way, so
+//	they are considered passable).  A traveler that steps to a neighbor
+//	with a smaller distance is on a shortest path out of the maze.
+//
+//	The field gets computed once at startup, by a breadth-first search
+//	from the exit that expands each level of the search on all the workers
+//	of a pool at once.  After that, the partitions report the squares
+//	their slides touch, and repair() brings the field up to date by
+//	visiting only the squares whose distance depends on them (the way
+//	dynamic shortest-path algorithms like LPA* do), never the whole grid.
+
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "arena.h"
+#include "dataTypes.h"
+#include "grid.h"
+#include "randomStream.h"
+
+class WorkerPool;
+
+class DistanceField
+{
+	public:
+
+		//	distance of a square the exit can't be reached from
+		static const uint32_t UNREACHABLE = UINT32_MAX;
+
+		/**	Computes the field of the grid as it is now
+		 *	@param pool the workers that share the search
+		 */
+		void compute(const Grid& grid, const GridPosition& exitPos, WorkerPool& pool);
+
+		/**	Records that the blocks of a partition just slid by (dr, dc), so
+		 *	that the next repair() looks at the squares they left and
+		 *	entered.  Any thread can call this.
+		 */
+		void noteSlide(const ArenaArray<GridPosition>& blockList, int dr, int dc);
+
+		/**	Updates the distances around the squares noted since the last
+		 *	repair.  The caller must be the only thread using the field or
+		 *	writing to the grid (the end of a tick).
+		 *	@return the number of squares whose distance was looked at again
+		 */
+		size_t repair(const Grid& grid);
+
+		void release();
+
+		bool isReady() const { return distanceList != nullptr; }
+
+		uint32_t distance(unsigned int row, unsigned int col) const
+		{
+			return distanceList[static_cast<size_t>(row) * cols + col].load(std::memory_order_relaxed);
+		}
+
+		/**	@return a direction that leads from square (row, col) to a neighbor
+		 *	closer to the exit (drawn from rng if there are several), or
+		 *	NUM_DIRECTIONS if there is none
+		 */
+		Direction downhill(unsigned int row, unsigned int col, RandomStream& rng) const;
+
+	private:
+
+		void setDistance(size_t index, uint32_t d)
+		{
+			distanceList[index].store(d, std::memory_order_relaxed);
+		}
+
+		uint32_t distanceAt(size_t index) const
+		{
+			return distanceList[index].load(std::memory_order_relaxed);
+		}
+
+		bool hasNeighborAt(size_t index, uint32_t d) const;
+		uint32_t closestNeighbor(size_t index) const;
+
+		unsigned int rows = 0;
+		unsigned int cols = 0;
+		//	one per square, in Grid::index() order
+		std::unique_ptr<std::atomic<uint32_t>[]> distanceList;
+		//	whether the field treats the square as an obstacle (it may be
+		//	behind the grid until the next repair())
+		std::vector<uint8_t> obstacleList;
+		//	squares noted since the last repair (maybe more than once)
+		std::vector<uint32_t> changedList;
+		std::mutex changedMutex;
+};
+
+#endif //	DISTANCE_FIELD_H
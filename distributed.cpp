@@ -0,0 +1,148 @@
+//
+//  distributed.cpp
+//  Final Project CSC412
+//
+//	Driver for a distributed run on one host:  the grid is split into
+//	--processes bands of rows, each one simulated by its own process (rank),
+//	and the ranks exchange the travelers that cross a band border through
+//	the --transport (shared memory, or TCP over the loopback interface).
+//	The parent process generates the world, forks the ranks, and waits for
+//	them.  Rank 0 reports the results, after checking that the world it
+//	gathered from all the ranks is consistent.  Exit status is 0 only if
+//	every rank finished and the check passed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+//
+#include <sys/wait.h>
+#include <unistd.h>
+#include "simulation.h"
+#include "transport.h"
+
+using namespace std;
+
+//	What rank 0 does once its band is done:  check and report
+int reportResults(double initElapsed, double runElapsed)
+{
+	string problem;
+	bool ok = checkGridConsistency(problem);
+	unsigned long numMoves = numMovesDone.load();
+
+	string label = "dist/" + transportStr(transportMode);
+	printf("%-10s %10.3f %8u %10lu %10.3f %12lu %12.0f  %s\n",
+		   label.c_str(), initElapsed, numTravelersDone, numTicksDone.load(), runElapsed,
+		   numMoves, runElapsed > 0 ? numMoves / runElapsed : 0.0,
+		   ok ? "ok" : ("INCONSISTENT: " + problem).c_str());
+	fflush(stdout);
+
+	return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+	travelerSleepTime = 0;
+	parseArguments(argc, argv);
+	numProcesses = min(numProcesses, numRows);
+	//	the ranks only exchange the heads of the travelers
+	if (numInitialSegments > 1 || movesPerGrowth > 0)
+	{
+		fprintf(stderr, "%s: distributed runs only move single-segment travelers\n", argv[0]);
+		numInitialSegments = 1;
+		movesPerGrowth = 0;
+	}
+
+	printf("grid:       %u x %u\n", numRows, numCols);
+	printf("travelers:  %u\n", numTravelers);
+	printf("processes:  %u\n", numProcesses);
+	printf("transport:  %s\n", transportStr(transportMode).c_str());
+	printf("seed:       %lu\n", randomSeed);
+	printf("\n%-10s %10s %8s %10s %10s %12s %12s\n",
+		   "run", "init (s)", "solved", "ticks", "run (s)", "moves", "moves/sec");
+	fflush(stdout);
+
+	//	The ranks inherit the world through fork().  Ranks on other hosts
+	//	would generate the very same one from the seed instead.
+	engineMode = EngineMode::REGION;
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	initializeApplication();
+	double initElapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	//	The transport must exist before the fork:  the shared memory gets
+	//	mapped in every rank, and each rank inherits its listening socket.
+	unique_ptr<SharedMemoryTransport> sharedMemory;
+	vector<sockaddr_in> addressList(numProcesses);
+	vector<int> listenSocketList(numProcesses, -1);
+	if (transportMode == TransportMode::SHARED_MEMORY)
+		sharedMemory.reset(new SharedMemoryTransport(numProcesses, maxRankMessageSize()));
+	else
+	{
+		for (unsigned int r=0; r<numProcesses; r++)
+			listenSocketList[r] = TcpTransport::listenOnLoopback(addressList[r]);
+	}
+
+	vector<pid_t> rankList;
+	for (unsigned int rank=0; rank<numProcesses; rank++)
+	{
+		pid_t pid = fork();
+		if (pid < 0)
+		{
+			perror("fork");
+			exit(1);
+		}
+		if (pid > 0)
+		{
+			rankList.push_back(pid);
+			continue;
+		}
+
+		//	Rank process from here on
+		unique_ptr<TcpTransport> tcp;
+		Transport* transport = sharedMemory.get();
+		if (sharedMemory)
+			sharedMemory->setRank(rank);
+		else
+		{
+			for (unsigned int r=0; r<numProcesses; r++)
+			{
+				if (r != rank)
+					close(listenSocketList[r]);
+			}
+			tcp.reset(new TcpTransport(rank, addressList, listenSocketList[rank]));
+			transport = tcp.get();
+		}
+
+		chrono::steady_clock::time_point runTime = chrono::steady_clock::now();
+		runDistributedRank(*transport);
+		double runElapsed = chrono::duration<double>(chrono::steady_clock::now() - runTime).count();
+
+		int status = (rank == 0) ? reportResults(initElapsed, runElapsed) : 0;
+		tcp.reset();
+		sharedMemory.reset();
+		cleanupSimulation();
+		exit(status);
+	}
+
+	for (int sock : listenSocketList)
+	{
+		if (sock >= 0)
+			close(sock);
+	}
+
+	bool allOk = true;
+	for (pid_t pid : rankList)
+	{
+		int status;
+		if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			allOk = false;
+	}
+	if (!allOk)
+		fprintf(stderr, "%s: a rank failed\n", argv[0]);
+
+	cleanupSimulation();
+	return allOk ? 0 : 1;
+}
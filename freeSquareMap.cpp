@@ -0,0 +1,164 @@
+//
+//  freeSquareMap.cpp
+//  Final Project CSC412
+//
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+//
+#include "freeSquareMap.h"
+#include "workerPool.h"
+
+using namespace std;
+
+//	One bit per byte of an 8-byte chunk of squares:  bit i is set if
+//	square i is free.  FREE_SQUARE is 0, so this finds the zero bytes:  the
+//	high bit of each byte ends up set only for those, and the multiply
+//	gathers the 8 high bits into the top byte.
+static inline uint64_t freeBits(const uint8_t* squares)
+{
+	const uint64_t LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+	uint64_t chunk;
+	memcpy(&chunk, squares, sizeof(chunk));
+	uint64_t isZero = ~(((chunk & LOW_BITS) + LOW_BITS) | chunk | LOW_BITS);
+	return (isZero >> 7) * 0x0102040810204080ULL >> 56;
+}
+
+void FreeSquareMap::build(const Grid& grid, WorkerPool& pool)
+{
+	static_assert(static_cast<int>(SquareType::FREE_SQUARE) == 0, "freeBits() looks for zero bytes");
+
+	rows = grid.numRows();
+	cols = grid.numCols();
+	numWords = (grid.size() + WORD_SQUARES - 1) / WORD_SQUARES;
+	numBlocks = (numWords + BLOCK_WORDS - 1) / BLOCK_WORDS;
+	wordList.reset(new atomic<uint64_t>[numWords]);
+
+	//	Each worker packs the squares of its own range of words into bits
+	const uint8_t* squares = grid.squareBytes();
+	const size_t numSquares = grid.size();
+	const unsigned int numWorkersInPool = pool.size();
+	pool.run([&](unsigned int workerIndex) {
+		size_t firstWord = numWords * workerIndex / numWorkersInPool;
+		size_t lastWord = numWords * (workerIndex + 1) / numWorkersInPool;
+		for (size_t w=firstWord; w<lastWord; w++)
+		{
+			size_t first = w * WORD_SQUARES;
+			uint64_t word = 0;
+			if (first + WORD_SQUARES <= numSquares)
+			{
+				for (size_t i=0; i<WORD_SQUARES; i+=8)
+					word |= freeBits(squares + first + i) << i;
+			}
+			else
+			{
+				for (size_t i=0; first + i < numSquares; i++)
+					word |= static_cast<uint64_t>(squares[first + i] == 0) << i;
+			}
+			wordList[w].store(word, memory_order_relaxed);
+		}
+	});
+
+	recount(pool);
+}
+
+void FreeSquareMap::recount(WorkerPool& pool)
+{
+	//	each worker counts the free squares of its own range of blocks into
+	//	the tree's leaves
+	//	(as many leaves as the next power of two, so that select() never
+	//	steps out of the tree)
+	numTreeLeaves = 1;
+	while (numTreeLeaves < numBlocks)
+		numTreeLeaves *= 2;
+	tree.assign(numTreeLeaves + 1, 0);
+	const unsigned int numWorkersInPool = pool.size();
+	pool.run([&](unsigned int workerIndex) {
+		size_t firstBlock = numBlocks * workerIndex / numWorkersInPool;
+		size_t lastBlock = numBlocks * (workerIndex + 1) / numWorkersInPool;
+		for (size_t b=firstBlock; b<lastBlock; b++)
+		{
+			uint32_t blockCount = 0;
+			for (size_t w=b*BLOCK_WORDS; w<min((b+1)*BLOCK_WORDS, numWords); w++)
+				blockCount += static_cast<uint32_t>(__builtin_popcountll(wordList[w].load(memory_order_relaxed)));
+			tree[b + 1] = blockCount;
+		}
+	});
+
+	//	then each node of the tree adds itself to its parent, in one pass
+	for (size_t node=1; node<=numTreeLeaves; node++)
+	{
+		size_t parent = node + (node & (~node + 1));
+		if (parent <= numTreeLeaves)
+			tree[parent] += tree[node];
+	}
+	numFree = rank(numBlocks * BLOCK_SQUARES);
+}
+
+void FreeSquareMap::release()
+{
+	wordList.reset();
+	tree.clear();
+	tree.shrink_to_fit();
+	rows = cols = 0;
+	numWords = numBlocks = numTreeLeaves = 0;
+	numFree = 0;
+}
+
+size_t FreeSquareMap::rank(size_t index) const
+{
+	size_t block = index / BLOCK_SQUARES;
+	size_t total = 0;
+	for (size_t node = block; node > 0; node -= node & (~node + 1))
+		total += tree[node];
+	return total + countRange(block * BLOCK_SQUARES, index);
+}
+
+size_t FreeSquareMap::select(size_t k) const
+{
+	assert(k < numFree);
+
+	//	descend the tree to the block that holds free square k (the steps
+	//	go one way or the other at random, so no branches)
+	size_t block = 0;
+	for (size_t step = numTreeLeaves / 2; step > 0; step /= 2)
+	{
+		uint32_t nodeCount = tree[block + step];
+		bool isFurther = nodeCount <= k;
+		block += isFurther ? step : 0;
+		k -= isFurther ? nodeCount : 0;
+	}
+
+	return selectInRange(block * BLOCK_SQUARES, min((block + 1) * BLOCK_SQUARES, numWords * WORD_SQUARES), k);
+}
+
+size_t FreeSquareMap::countRange(size_t first, size_t last) const
+{
+	size_t total = 0;
+	while (first < last)
+	{
+		size_t w = first / WORD_SQUARES;
+		size_t lastBit = min(last - w * WORD_SQUARES, WORD_SQUARES);
+		uint64_t word = wordList[w].load(memory_order_relaxed) & wordMask(first % WORD_SQUARES, lastBit);
+		total += __builtin_popcountll(word);
+		first = (w + 1) * WORD_SQUARES;
+	}
+	return total;
+}
+
+size_t FreeSquareMap::selectInRange(size_t first, size_t last, size_t k) const
+{
+	while (first < last)
+	{
+		size_t w = first / WORD_SQUARES;
+		size_t lastBit = min(last - w * WORD_SQUARES, WORD_SQUARES);
+		uint64_t word = wordList[w].load(memory_order_relaxed) & wordMask(first % WORD_SQUARES, lastBit);
+		size_t wordCount = __builtin_popcountll(word);
+		if (k < wordCount)
+			return w * WORD_SQUARES + selectInWord(word, k);
+		k -= wordCount;
+		first = (w + 1) * WORD_SQUARES;
+	}
+	return last;
+}
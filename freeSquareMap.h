@@ -0,0 +1,162 @@
+//
+//  freeSquareMap.h
+//  Final Project CSC412
+//
+//	Which squares of the grid are free, one bit per square (in
+//	Grid::index() order), with the number of free squares of each block of
+//	BLOCK_SQUARES kept in a Fenwick tree.  That gives the rank of a square
+//	(how many free squares come before it) and its inverse, the select of
+//	the k-th free square, in O(log) time plus a few popcounts, so that a
+//	uniformly random free square costs the same however full the grid is.
+//
+//	The initialization builds it once the walls and partitions are in
+//	place, and keeps it up to date while it places the travelers.  The
+//	engines don't maintain it:  nothing looks for free squares once the
+//	simulation runs.
+
+#ifndef FREE_SQUARE_MAP_H
+#define FREE_SQUARE_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "dataTypes.h"
+#include "grid.h"
+
+class WorkerPool;
+
+class FreeSquareMap
+{
+	public:
+
+		static constexpr size_t WORD_SQUARES = 64;
+		static constexpr size_t BLOCK_WORDS = 8;
+		static constexpr size_t BLOCK_SQUARES = BLOCK_WORDS * WORD_SQUARES;
+
+		/**	Builds the map of the grid as it is now
+		 *	@param pool the workers that share the work, each one a range of
+		 *			blocks
+		 */
+		void build(const Grid& grid, WorkerPool& pool);
+
+		/**	Counts the free squares of each block again, after clearSquare()
+		 */
+		void recount(WorkerPool& pool);
+
+		void release();
+
+		/**	Number of free squares
+		 */
+		size_t count() const { return numFree; }
+
+		bool isFree(size_t index) const
+		{
+			return (wordList[index / WORD_SQUARES].load(std::memory_order_relaxed) >> (index % WORD_SQUARES)) & 1;
+		}
+
+		bool isFree(unsigned int row, unsigned int col) const
+		{
+			return isFree(static_cast<size_t>(row) * cols + col);
+		}
+
+		/**	@return the directions (bit 1 << Direction) in which square
+		 *	(row, col) has a free neighbor
+		 */
+		unsigned int freeNeighbors(unsigned int row, unsigned int col) const
+		{
+			unsigned int mask = 0;
+			for (int d=0; d<static_cast<int>(Direction::NUM_DIRECTIONS); d++)
+			{
+				//	a step off row or column 0 wraps around to a huge unsigned value
+				unsigned int nr = row + DIRECTION_ROW_STEP[d];
+				unsigned int nc = col + DIRECTION_COL_STEP[d];
+				if (nr < rows && nc < cols && isFree(nr, nc))
+					mask |= 1U << d;
+			}
+			return mask;
+		}
+
+		/**	Takes a square out of the map (nothing happens if it wasn't
+		 *	free).  One thread at a time.
+		 */
+		void markTaken(size_t index)
+		{
+			if (clearSquare(index))
+			{
+				for (size_t node = index / BLOCK_SQUARES + 1; node <= numTreeLeaves; node += node & (~node + 1))
+					tree[node]--;
+				numFree--;
+			}
+		}
+
+		/**	Takes a square out of the bits only.  Several threads can do
+		 *	that at once, and countRange() and selectInRange() see it right
+		 *	away, but the other queries only after recount().
+		 *	@return whether the square was free
+		 */
+		bool clearSquare(size_t index)
+		{
+			uint64_t bit = uint64_t(1) << (index % WORD_SQUARES);
+			return wordList[index / WORD_SQUARES].fetch_and(~bit, std::memory_order_relaxed) & bit;
+		}
+
+		/**	@return the number of free squares before square index
+		 */
+		size_t rank(size_t index) const;
+
+		/**	@return the index of free square number k (from 0).  k must be
+		 *	below count():  past that, the descent of the tree stops in the
+		 *	last block and the result can be past the end of the grid, so
+		 *	this asserts it.
+		 */
+		size_t select(size_t k) const;
+
+		/**	Same as rank() and select(), restricted to squares [first, last)
+		 *	and without the tree:  they only read the bits of the range, so
+		 *	they can run while other threads take squares elsewhere.  Cost
+		 *	proportional to the length of the range.  selectInRange()
+		 *	returns last if the range has k or fewer free squares.
+		 */
+		size_t countRange(size_t first, size_t last) const;
+		size_t selectInRange(size_t first, size_t last, size_t k) const;
+
+	private:
+
+		//	bits [firstBit, lastBit) of a word
+		static uint64_t wordMask(size_t firstBit, size_t lastBit)
+		{
+			uint64_t high = (lastBit == WORD_SQUARES) ? ~uint64_t(0) : (uint64_t(1) << lastBit) - 1;
+			return high & (~uint64_t(0) << firstBit);
+		}
+
+		//	position of the k-th set bit of a word that has more than k:
+		//	skip whole bytes, then bits
+		static unsigned int selectInWord(uint64_t word, size_t k)
+		{
+			unsigned int shift = 0;
+			for (size_t byteCount; k >= (byteCount = __builtin_popcountll(word & 0xFF)); shift += 8)
+			{
+				k -= byteCount;
+				word >>= 8;
+			}
+			for (; k > 0; k--)
+				word &= word - 1;
+			return shift + static_cast<unsigned int>(__builtin_ctzll(word));
+		}
+
+		unsigned int rows = 0;
+		unsigned int cols = 0;
+		size_t numWords = 0;
+		size_t numBlocks = 0;
+		size_t numTreeLeaves = 0;
+		//	atomic, for clearSquare()
+		std::unique_ptr<std::atomic<uint64_t>[]> wordList;
+		//	Fenwick tree of the blocks' free counts (1-based, tree[0] unused),
+		//	with empty leaves up to numTreeLeaves
+		std::vector<uint32_t> tree;
+		size_t numFree = 0;
+};
+
+#endif //	FREE_SQUARE_MAP_H
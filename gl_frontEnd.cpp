@@ -20,6 +20,7 @@
  |	very thin (basically, I just scopped the FontSize enum type).			|
  +-------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
@@ -41,10 +42,8 @@ using namespace std;
 const extern int MAX_NUM_MESSAGES;
 const extern int MAX_LENGTH_MESSAGE;
 
-extern SquareType** grid;
 extern unsigned int numRows;			//	height of the grid
 extern unsigned int numCols;			//	width
-extern unsigned int numLiveThreads;		//	the number of live traveler threads
 extern GLint refreshMillisecs;			//	number of milliseconds between screen refreshes
 #if 0
 //-----------------------------------------------------------------------------
@@ -74,7 +73,7 @@ void myGridPaneMouseFunc(int b, int s, int x, int y);
 void myStatePaneMouse(int b, int s, int x, int y);
 void myKeyboardFunc(unsigned char c, int x, int y);
 void myTimerFunc(int val);
-void drawGrid(void);
+void drawGrid(const FrameSnapshot& frame);
 void drawLock(unsigned int i, unsigned int j, float DH, float DV);
 
 #if 0
@@ -128,7 +127,59 @@ int	gMainWindow,
 //-----------------------------------------------------------------------------
 #endif
 
-void drawTraveler(const shared_ptr<Traveler> traveler)
+//	Everything in the grid pane is drawn through vertex batches, with one
+//	color per vertex:  the travelers' heads, all the lines, and the squares
+//	(kept in a cache, see TileCache).  drawTraveler() and drawGrid() only
+//	fill them;  displayGridPaneFunc() then submits each batch with a single
+//	glDrawArrays call.  Client-side arrays are plain OpenGL 1.1, so this
+//	also runs on software Mesa.  The vectors keep their capacity from one
+//	frame to the next.
+struct VertexBatch
+{
+	std::vector<GLfloat> vertexList;	//	x, y
+	std::vector<GLfloat> colorList;		//	r, g, b, a
+
+	void clear()
+	{
+		vertexList.clear();
+		colorList.clear();
+	}
+
+	void add(GLfloat x, GLfloat y, const GLfloat* rgba)
+	{
+		vertexList.push_back(x);
+		vertexList.push_back(y);
+		colorList.insert(colorList.end(), rgba, rgba + 4);
+	}
+
+	//	axis-aligned rectangle, as one quad
+	void addRect(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, const GLfloat* rgba)
+	{
+		add(x0, y0, rgba);
+		add(x1, y0, rgba);
+		add(x1, y1, rgba);
+		add(x0, y1, rgba);
+	}
+
+	void addLine(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, const GLfloat* rgba)
+	{
+		add(x0, y0, rgba);
+		add(x1, y1, rgba);
+	}
+
+	void draw(GLenum mode) const
+	{
+		if (vertexList.empty())
+			return;
+		glVertexPointer(2, GL_FLOAT, 0, vertexList.data());
+		glColorPointer(4, GL_FLOAT, 0, colorList.data());
+		glDrawArrays(mode, 0, static_cast<GLsizei>(vertexList.size() / 2));
+	}
+};
+
+VertexBatch quadBatch, lineBatch;
+
+void drawTraveler(const TravelerFrame& traveler, const TravelerSegment* segmentList)
 {
 	//	Yes, I know that it's inefficient/dumb to recompute this each and every
 	//	the a traveler gets drawn, but gcc on Ubuntu doesn't let me define these
@@ -141,194 +192,228 @@ void drawTraveler(const shared_ptr<Traveler> traveler)
 									{0, -DV},	//	SOUTH
 									{-DH, 0}};	//	EAST
 
-	glColor4fv(traveler->rgba);
-	glPushMatrix();
-	//	The first segment is different
-	glTranslatef((traveler->segmentList[0].col + 0.5f)*DH,
-				 (traveler->segmentList[0].row + 0.5f)*DV, 0.f);
-	//	draw the "head"
-	glPushMatrix();
-	glScalef(0.2f, 0.2f, 1.f);
-	glBegin(GL_POLYGON);
-		glVertex2f(0, DV);
-		glVertex2f(-DH, 0);
-		glVertex2f(0, -DV);
-		glVertex2f(DH, 0);
-	glEnd();
-	glPopMatrix();
-	size_t numSegments = traveler->segmentList.size();
+	segmentList += traveler.firstSegment;
+	const GLfloat* rgba = traveler.rgba;
+
+	//	The first segment is different:  draw the "head" (a diamond)
+	GLfloat x = (segmentList[0].col + 0.5f)*DH,
+			y = (segmentList[0].row + 0.5f)*DV;
+	quadBatch.add(x, y + 0.2f*DV, rgba);
+	quadBatch.add(x - 0.2f*DH, y, rgba);
+	quadBatch.add(x, y - 0.2f*DV, rgba);
+	quadBatch.add(x + 0.2f*DH, y, rgba);
+
+	size_t numSegments = traveler.numSegments;
 	if (numSegments > 1)
 	{
 		for (size_t currSegIndex=0; currSegIndex < numSegments-1; currSegIndex++)
 		{
-			int dirInt = static_cast<int>(traveler->segmentList[currSegIndex].dir);
-
-			//	draw a segment to the center of the next square
-			glBegin(GL_LINES);
-				glVertex2f(0, 0);
-				glVertex2f(segMove[dirInt][0],
-						   segMove[dirInt][1]);
-			glEnd();
-			
-			//	and move to that point
-			glTranslatef(segMove[dirInt][0],
-						 segMove[dirInt][1],
-						 0.f);
+			int dirInt = static_cast<int>(segmentList[currSegIndex].dir);
 
+			//	draw a segment to the center of the next square, and move there
+			lineBatch.addLine(x, y, x + segMove[dirInt][0], y + segMove[dirInt][1], rgba);
+			x += segMove[dirInt][0];
+			y += segMove[dirInt][1];
 		}
 		//	The last segment is a bit shorter
-        glBegin(GL_LINES);
-            glVertex2f(0, 0);
-            glVertex2f(segMove[static_cast<int>(traveler->segmentList[numSegments-1].dir)][0]*0.2f,
-                       segMove[static_cast<int>(traveler->segmentList[numSegments-1].dir)][1]*0.2f);
-        glEnd();
+		int dirInt = static_cast<int>(segmentList[numSegments-1].dir);
+		lineBatch.addLine(x, y, x + segMove[dirInt][0]*0.2f, y + segMove[dirInt][1]*0.2f, rgba);
 	}
 	else
 	{
 		//	draw the only segment
-		glBegin(GL_LINES);
-			glVertex2f(0, 0);
-			glVertex2f(segMove[static_cast<int>(traveler->segmentList[0].dir)][0]*0.4f,
-					   segMove[static_cast<int>(traveler->segmentList[0].dir)][1]*0.4f);
-		glEnd();	}
-	
-	glPopMatrix();
-
+		int dirInt = static_cast<int>(segmentList[0].dir);
+		lineBatch.addLine(x, y, x + segMove[dirInt][0]*0.4f, y + segMove[dirInt][1]*0.4f, rgba);
+	}
 }
 
-//	This is the function that does the actual grid drawing
-void drawGrid(void)
+//	The squares' quads are cached from one frame to the next, in one pair
+//	of arrays where every tile of the frame has its own slot, and only the
+//	tiles the frame lists as dirty get rebuilt.  A slot keeps some spare
+//	room, filled with empty quads (all four vertices at the origin, which
+//	produce no pixel), so that a tile can gain a few quads without moving.
+//	A tile that outgrows its slot moves to the end of the arrays, and its
+//	old slot is emptied;  everything gets rebuilt once that wasted space
+//	reaches half of the arrays.  The whole cache is one glDrawArrays call.
+struct TileCache
+{
+	VertexBatch quads;
+	//	per tile:  its slot, in vertices
+	std::vector<size_t> firstVertex;
+	std::vector<size_t> capacity;
+	size_t numWastedVertices = 0;
+	//	what the cache shows
+	unsigned long sequence = 0;
+	unsigned int numRows = 0;
+	unsigned int numCols = 0;
+	//	the exit never moves, so its lines are drawn from here
+	bool hasExit = false;
+	unsigned int exitRow = 0, exitCol = 0;
+	//	quads of the tile being rebuilt
+	VertexBatch tileQuads;
+
+	//	room for a few traveler dots on top of what the tile holds now
+	static const size_t SLOT_SLACK = 16;
+
+	void update(const FrameSnapshot& frame);
+	void buildTile(const FrameSnapshot& frame, size_t tile);
+	void placeTile(size_t tile);
+	void emptySlot(size_t first, size_t count);
+};
+
+TileCache tileCache;
+
+//	Builds the quads of one tile into tileQuads
+void TileCache::buildTile(const FrameSnapshot& frame, size_t tile)
 {
 	static const GLfloat	DH = (GRID_PANE_WIDTH - 2.f)/ numCols,
 							DV = (GRID_PANE_HEIGHT - 2.f) / numRows;
 	static const GLfloat	PS = 0.3f, PE = 1.f - PS;
+	//	     red  green blue
+	static const GLfloat	TRAV_DOT_COLOR[4] = {0.f, 1.f, 0.f, 1.f};
+
+	unsigned int firstRow = static_cast<unsigned int>(tile / frame.tileCols) << frame.tileShift;
+	unsigned int firstCol = static_cast<unsigned int>(tile % frame.tileCols) << frame.tileShift;
+	unsigned int endRow = std::min(frame.numRows, firstRow + (1U << frame.tileShift));
+	unsigned int endCol = std::min(frame.numCols, firstCol + (1U << frame.tileShift));
 
-	//	draw the walls and partitions
-	for (unsigned int i=0; i< numRows; i++)
+	tileQuads.clear();
+	for (unsigned int i=firstRow; i<endRow; i++)
 	{
-		for (unsigned int j=0; j< numCols; j++)
+		const SquareType* square = frame.squareList.data() + static_cast<size_t>(i) * frame.numCols;
+		for (unsigned int j=firstCol; j<endCol; j++)
 		{
-			switch (grid[i][j])
+			switch (square[j])
 			{
 				case SquareType::WALL:
-					glColor4fv(WALL_COLOR);
-					glBegin(GL_POLYGON);
-						glVertex2f(j*DH, i*DV);
-						glVertex2f((j+1)*DH, i*DV);
-						glVertex2f((j+1)*DH, (i+1)*DV);
-						glVertex2f(j*DH, (i+1)*DV);
-					glEnd();
+					tileQuads.addRect(j*DH, i*DV, (j+1)*DH, (i+1)*DV, WALL_COLOR);
 					break;
 					
 				case SquareType::VERTICAL_PARTITION:
-					glColor4fv(PART_COLOR);
-					glBegin(GL_POLYGON);
-						glVertex2f((j+PS)*DH, i*DV);
-						glVertex2f((j+PE)*DH, i*DV);
-						glVertex2f((j+PE)*DH, (i+1)*DV);
-						glVertex2f((j+PS)*DH, (i+1)*DV);
-					glEnd();
+					tileQuads.addRect((j+PS)*DH, i*DV, (j+PE)*DH, (i+1)*DV, PART_COLOR);
 					break;
 					
 				case SquareType::HORIZONTAL_PARTITION:
-					glColor4fv(PART_COLOR);
-					glBegin(GL_POLYGON);
-						glVertex2f(j*DH, (i+PS)*DV);
-						glVertex2f((j+1)*DH, (i+PS)*DV);
-						glVertex2f((j+1)*DH, (i+PE)*DV);
-						glVertex2f(j*DH, (i+PE)*DV);
-					glEnd();
+					tileQuads.addRect(j*DH, (i+PS)*DV, (j+1)*DH, (i+PE)*DV, PART_COLOR);
 					break;
 					
 				case SquareType::EXIT:
-					glColor4fv(EXIT_COLOR);
-					glBegin(GL_POLYGON);
-						glVertex2f(j*DH, i*DV);
-						glVertex2f((j+1)*DH, i*DV);
-						glVertex2f((j+1)*DH, (i+1)*DV);
-						glVertex2f(j*DH, (i+1)*DV);
-					glEnd();
-					glColor4f(0.f, 0.f, 0.f, 1.f);
-					glBegin(GL_LINES);
-						glVertex2f(j*DH, i*DV);
-						glVertex2f((j+1)*DH, (i+1)*DV);
-						glVertex2f((j+1)*DH, i*DV);
-						glVertex2f(j*DH, (i+1)*DV);
-						glVertex2f(j*DH, (i+0.5f)*DV);
-						glVertex2f((j+1)*DH, (i+0.5f)*DV);
-						glVertex2f((j+0.5f)*DH, i*DV);
-						glVertex2f((j+0.5f)*DH, (i+1.f)*DV);
-					glEnd();
+					tileQuads.addRect(j*DH, i*DV, (j+1)*DH, (i+1)*DV, EXIT_COLOR);
+					hasExit = true;
+					exitRow = i;
+					exitCol = j;
 					break;
 				
+				//	This displays a small green square in the upper-left
+				//	corner of grid squares that are in state "TRAVELER".  This lets
+				//	you verify that you properly update the grid.
+				case SquareType::TRAVELER:
+				{
+					const float TRAV_DOT_SIZE = 0.2f;	//	fraction of square size
+					tileQuads.addRect(j*DH, i*DV, (j+TRAV_DOT_SIZE)*DH, (i+TRAV_DOT_SIZE)*DV, TRAV_DOT_COLOR);
+					break;
+				}
+
 				default:
 					//	nothing
 					break;
 			}
-	
-			//	This piece of code displays a small blue square in the upper-left
-			//	corner of grid squares that is in state "TRAVELER".  This lets
-			//	you verify that you properly update the grid.
-			if (grid[i][j] == SquareType::TRAVELER)
-			{
-				//	     red  green blue
-				glColor4f(0.f, 1.f, 0.f, 1.f);
-				
-				const float TRAV_DOT_SIZE = 0.2f;	//	fraction of square size
-
-				glBegin(GL_POLYGON);
-					glVertex2f(j*DH, i*DV);
-					glVertex2f((j+TRAV_DOT_SIZE)*DH, i*DV);
-					glVertex2f((j+TRAV_DOT_SIZE)*DH, (i+TRAV_DOT_SIZE)*DV);
-					glVertex2f(j*DH, (i+TRAV_DOT_SIZE)*DV);
-				glEnd();
-			
-			}
-
-//	Possibly enable for later versions of the assignment.
-//
-//	Assuming that you have defined (and properly allocated and initialized)
-//	somewhere a 2D array or 2D vector of mutex locks, so
-//		mutex** gridLock;
-//	or
-//		vector<vector<mutex> > lockGrid;
-//
-//	the following piece of code whould display small magenta "locks" at
-//	squares where the mutex has been acquired.  That will let you see
-//	if you fail to acquire locks or to release locks after your traveler has
-//	moved away
-//
-//			if (grid[i][j] != SquareType::WALL && grid[i][j] != SquareType::EXIT)
-//			{
-//				if (lockGrid[i][j].try_lock())
-//				{
-//					lockGrid[i][j].unlock();
-//				}
-//				else
-//				{
-//					drawLock(i, j, DH, DV);
-//				}
-//			}
 		}
 	}
-	
-	//	Then draw a grid of lines on top of the squares
-	glColor4f(0.5f, 0.5f, 0.5f, 1.f);
-	glBegin(GL_LINES);
-		//	Horizontal
-		for (unsigned int i=0; i<= numRows+1; i++)
+}
+
+void TileCache::emptySlot(size_t first, size_t count)
+{
+	std::fill(quads.vertexList.begin() + 2*first, quads.vertexList.begin() + 2*(first + count), 0.f);
+}
+
+//	Copies tileQuads into the tile's slot, moving the slot to the end of
+//	the arrays if it is too small
+void TileCache::placeTile(size_t tile)
+{
+	size_t numVertices = tileQuads.vertexList.size() / 2;
+	if (numVertices > capacity[tile])
+	{
+		emptySlot(firstVertex[tile], capacity[tile]);
+		numWastedVertices += capacity[tile];
+
+		firstVertex[tile] = quads.vertexList.size() / 2;
+		capacity[tile] = numVertices + SLOT_SLACK;
+		quads.vertexList.resize(quads.vertexList.size() + 2*capacity[tile]);
+		quads.colorList.resize(quads.colorList.size() + 4*capacity[tile]);
+	}
+
+	size_t first = firstVertex[tile];
+	std::copy(tileQuads.vertexList.begin(), tileQuads.vertexList.end(), quads.vertexList.begin() + 2*first);
+	std::copy(tileQuads.colorList.begin(), tileQuads.colorList.end(), quads.colorList.begin() + 4*first);
+	emptySlot(first + numVertices, capacity[tile] - numVertices);
+}
+
+void TileCache::update(const FrameSnapshot& frame)
+{
+	if (frame.sequence == sequence && frame.numRows == numRows && frame.numCols == numCols)
+		return;
+
+	size_t numTiles = (frame.tileCols == 0) ? 0 :
+						static_cast<size_t>(((frame.numRows - 1) >> frame.tileShift) + 1) * frame.tileCols;
+	bool rebuildAll = frame.numRows != numRows || frame.numCols != numCols ||
+					  frame.baseSequence != sequence || firstVertex.size() != numTiles ||
+					  2 * numWastedVertices > quads.vertexList.size() / 2;
+
+	if (rebuildAll)
+	{
+		numRows = frame.numRows;
+		numCols = frame.numCols;
+		quads.clear();
+		firstVertex.assign(numTiles, 0);
+		capacity.assign(numTiles, 0);
+		numWastedVertices = 0;
+		hasExit = false;
+		//	(a tile without any square to draw gets a slot once it has one)
+		for (size_t t=0; t<numTiles; t++)
 		{
-			glVertex2f(0.5f, 0.5f + i*DV);
-			glVertex2f(0.5f + numCols*DH, 0.5f + i*DV);
+			buildTile(frame, t);
+			placeTile(t);
 		}
-		//	Vertical
-		for (unsigned int j=0; j<= numCols+1; j++)
+	}
+	else
+	{
+		for (uint32_t t : frame.dirtyTileList)
 		{
-			glVertex2f(0.5f + j*DH, 0.5f);
-			glVertex2f(0.5f + j*DH, 0.5f + numRows*DV);
+			buildTile(frame, t);
+			placeTile(t);
 		}
-	glEnd();
+	}
+	sequence = frame.sequence;
+}
+
+//	This is the function that does the actual grid drawing:  it brings the
+//	cached squares up to date, and adds the lines to the line batch
+void drawGrid(const FrameSnapshot& frame)
+{
+	static const GLfloat	DH = (GRID_PANE_WIDTH - 2.f)/ numCols,
+							DV = (GRID_PANE_HEIGHT - 2.f) / numRows;
+	static const GLfloat	BLACK[4] = {0.f, 0.f, 0.f, 1.f};
+	static const GLfloat	GRID_LINE_COLOR[4] = {0.5f, 0.5f, 0.5f, 1.f};
+
+	tileCache.update(frame);
+
+	if (tileCache.hasExit)
+	{
+		unsigned int i = tileCache.exitRow, j = tileCache.exitCol;
+		lineBatch.addLine(j*DH, i*DV, (j+1)*DH, (i+1)*DV, BLACK);
+		lineBatch.addLine((j+1)*DH, i*DV, j*DH, (i+1)*DV, BLACK);
+		lineBatch.addLine(j*DH, (i+0.5f)*DV, (j+1)*DH, (i+0.5f)*DV, BLACK);
+		lineBatch.addLine((j+0.5f)*DH, i*DV, (j+0.5f)*DH, (i+1.f)*DV, BLACK);
+	}
 	
+	//	Then draw a grid of lines on top of the squares
+	//	Horizontal
+	for (unsigned int i=0; i<= numRows+1; i++)
+		lineBatch.addLine(0.5f, 0.5f + i*DV, 0.5f + numCols*DH, 0.5f + i*DV, GRID_LINE_COLOR);
+	//	Vertical
+	for (unsigned int j=0; j<= numCols+1; j++)
+		lineBatch.addLine(0.5f + j*DH, 0.5f, 0.5f + j*DH, 0.5f + numRows*DV, GRID_LINE_COLOR);
 }
 
 //	This function displays a small magenta lock in a corner of a
@@ -457,7 +542,7 @@ void displayTextualInfo(const char* infoStr, int xPos, int yPos, FontSize fontSi
 }
 
 
-void drawMessages(int numMessages, const char*const* message)
+void drawMessages(int numMessages, const char*const* message, unsigned int numLiveThreads)
 {
 	//	I compute once the dimensions for all the rendering of my state info
 	//	One other place to rant about that desperately lame gcc compiler.  It's
@@ -473,7 +558,7 @@ void drawMessages(int numMessages, const char*const* message)
 
 	//	display info about number of live threads
 	char infoStr[256];
-	sprintf(infoStr, "Live Threads: %d", numLiveThreads);
+	sprintf(infoStr, "Live Threads: %u", numLiveThreads);
 	displayTextualInfo(infoStr, LEFT_MARGIN, 7*STATE_PANE_HEIGHT/8,
 						FontSize::LARGE_FONT);
 }
@@ -503,7 +588,7 @@ void myResizeFunc(int w, int h)
 	}
 }
 
-void displayGridPaneFunc(void)
+void displayGridPaneFunc(const FrameSnapshot& frame)
 {
 	//	This is OpenGL/glut magic.  Don't touch
 	glutSetWindow(gSubwindow[GRID_PANE]);
@@ -514,9 +599,20 @@ void displayGridPaneFunc(void)
 	glTranslatef(0, GRID_PANE_HEIGHT, 0);
 	glScalef(1.f, -1.f, 1.f);
 	
-	drawAllTravelers();
-	
-	drawGrid();
+	//	build this frame's batches, then submit them:  one draw call per layer
+	//	(the squares, the travelers' heads, and all the lines)
+	quadBatch.clear();
+	lineBatch.clear();
+	drawAllTravelers(frame);
+	drawGrid(frame);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	tileCache.quads.draw(GL_QUADS);
+	quadBatch.draw(GL_QUADS);
+	lineBatch.draw(GL_LINES);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
 
 	//	This is OpenGL/glut magic.  Don't touch
 	glutSwapBuffers();
@@ -524,7 +620,13 @@ void displayGridPaneFunc(void)
 	glutSetWindow(gMainWindow);
 }
 
-void displayStatePaneFunc(void)
+//	glut callback (the pane redrawn on its own)
+void displayGridPaneFunc(void)
+{
+	displayGridPaneFunc(acquireFrame());
+}
+
+void displayStatePaneFunc(const FrameSnapshot& frame)
 {
 	//	This is OpenGL/glut magic.  Don't touch
 	glutSetWindow(gSubwindow[STATE_PANE]);
@@ -532,7 +634,7 @@ void displayStatePaneFunc(void)
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 
-	updateMessages();
+	updateMessages(frame);
 	
 	//	This is OpenGL/glut magic.  Don't touch
 	glutSwapBuffers();
@@ -540,6 +642,11 @@ void displayStatePaneFunc(void)
 	glutSetWindow(gMainWindow);
 }
 
+void displayStatePaneFunc(void)
+{
+	displayStatePaneFunc(acquireFrame());
+}
+
 void myDisplayFunc(void)
 {
     glutSetWindow(gMainWindow);
@@ -548,8 +655,10 @@ void myDisplayFunc(void)
     glClear(GL_COLOR_BUFFER_BIT);
     glutSwapBuffers();
 
-	displayGridPaneFunc();
-	displayStatePaneFunc();
+	//	both panes show the same frame, taken without any simulation lock
+	const FrameSnapshot& frame = acquireFrame();
+	displayGridPaneFunc(frame);
+	displayStatePaneFunc(frame);
 
     glutSetWindow(gMainWindow);
 }
@@ -691,71 +800,3 @@ void initializeFrontEnd(int argc, char* argv[])
 	glutMouseFunc(myGridPaneMouseFunc);
 	glutDisplayFunc(displayStatePaneFunc);
 }
-
-float** createTravelerColors(unsigned int numTravelers)
-{
-	float** travelerColor = new float*[numTravelers];
-
-	float hueStep = 360.f / numTravelers;
-
-	for (unsigned int k=0; k<numTravelers; k++)
-	{
-		travelerColor[k] = new float[4];
-		travelerColor[k][3] = 1.f;					//  alpha --> full opacity
-
-		//	compute a hue for the traveler
-		float hue = k*hueStep;
-		//	convert the hue to an RGB color
-		int hueRegion = (int) (hue / 60);
-		switch (hueRegion)
-		{
-				//  hue in [0, 60] -- red-green, dominant red
-			case 0:
-				travelerColor[k][0] = 1.f;					//  red is max
-				travelerColor[k][1] = hue / 60.f;			//  green calculated
-				travelerColor[k][2] = 0.f;					//  blue is zero
-				break;
-
-				//  hue in [60, 120] -- red-green, dominant green
-			case 1:
-				travelerColor[k][0] = (120.f - hue) / 60.f;	//  red is calculated
-				travelerColor[k][1] = 1.f;					//  green max
-				travelerColor[k][2] = 0.f;					//  blue is zero
-				break;
-
-				//  hue in [120, 180] -- green-blue, dominant green
-			case 2:
-				travelerColor[k][0] = 0.f;					//  red is zero
-				travelerColor[k][1] = 1.f;					//  green max
-				travelerColor[k][2] = (hue - 120.f) / 60.f;	//  blue is calculated
-				break;
-
-				//  hue in [180, 240] -- green-blue, dominant blue
-			case 3:
-				travelerColor[k][0] = 0.f;					//  red is zero
-				travelerColor[k][1] = (240.f - hue) / 60;	//  green calculated
-				travelerColor[k][2] = 1.f;					//  blue is max
-				break;
-
-				//  hue in [240, 300] -- blue-red, dominant blue
-			case 4:
-				travelerColor[k][0] = (hue - 240.f) / 60;	//  red is calculated
-				travelerColor[k][1] = 0;						//  green is zero
-				travelerColor[k][2] = 1.f;					//  blue is max
-				break;
-
-				//  hue in [300, 360] -- blue-red, dominant red
-			case 5:
-				travelerColor[k][0] = 1.f;					//  red is max
-				travelerColor[k][1] = 0;						//  green is zero
-				travelerColor[k][2] = (360.f - hue) / 60;	//  blue is calculated
-				break;
-
-			default:
-				break;
-
-		}
-	}
-
-	return travelerColor;
-}
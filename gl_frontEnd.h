@@ -57,22 +57,27 @@
 //	boxes and doors, so the two functions below will have to be called once for
 //	each pair robot/box and once for each door.
 
-//	This draws a colored multi-segment traveler
-void drawTraveler(const std::shared_ptr<Traveler> traveler);
+//	This draws a colored multi-segment traveler, from a frame snapshot.  Only
+//	call it from drawAllTravelers():  it adds the traveler to the grid pane's
+//	vertex batches, which get drawn once everything is in.
+void drawTraveler(const TravelerFrame& traveler, const TravelerSegment* segmentList);
 
 //	This function assigns a color to the door based on its number
 void drawDoor(int doorNumber, int doorRow, int doorCol);
 
-//	Defined in main.cpp
+//	Defined in main.cpp.  The drawing functions only read the frame (a
+//	snapshot the simulation published), never the live simulation state.
 void speedupTravelers();
 void slowdownTravelers();
-void drawAllTravelers();
-void updateMessages();
-void drawMessages(int numMessages, const char*const* message);
+void drawAllTravelers(const FrameSnapshot& frame);
+void updateMessages(const FrameSnapshot& frame);
+void drawMessages(int numMessages, const char*const* message, unsigned int numLiveThreads);
 void handleKeyboardEvent(unsigned char c, int x, int y);
 
+//	Defined in simulation.cpp:  the latest frame the simulation published
+const FrameSnapshot& acquireFrame(void);
+
 void initializeFrontEnd(int argc, char* argv[]);
-float** createTravelerColors(unsigned int numTravelers);
 
 #endif // GL_FRONT_END_H
 
@@ -0,0 +1,164 @@
+//
+//  grid.h
+//  Final Project CSC412
+//
+//	The state grid, stored as one contiguous row-major array of 1-byte
+//	squares.  A 10k x 10k grid is then 100 MB in a single allocation, and
+//	a square and its east/west neighbors share a cache line.
+//
+//	Squares are std::atomic so that the lock-free engine can claim them
+//	with compare-and-swap, and so that readers that hold no lock (the
+//	renderer) never see a torn value.  On the platforms we build for, a
+//	1-byte atomic load or store compiles to a plain load or store.
+//
+//	The grid can also record which tiles of squares got written to, so
+//	that the frames for the renderer only copy what changed.
+//
+//	A few spare squares follow the last one, so that vector code can read
+//	a whole word at any square (see squareBytes()).
+
+#ifndef GRID_H
+#define GRID_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "dataTypes.h"
+
+class Grid
+{
+	public:
+
+		/**	(Re)allocates the grid and sets every square to fillType
+		 */
+		void allocate(unsigned int numRows, unsigned int numCols,
+					  SquareType fillType = SquareType::FREE_SQUARE)
+		{
+			rows = numRows;
+			cols = numCols;
+			numCells = static_cast<size_t>(numRows) * numCols;
+			cells.reset(new std::atomic<SquareType>[numCells + READ_PADDING]);
+			for (size_t k=0; k<numCells + READ_PADDING; k++)
+				cells[k].store(fillType, std::memory_order_relaxed);
+			dirtyTiles.reset();
+			tileShift = 0;
+			tileCols = 0;
+			numTiles = 0;
+		}
+
+		/**	Frees the storage
+		 */
+		void release()
+		{
+			cells.reset();
+			rows = cols = 0;
+			numCells = 0;
+			dirtyTiles.reset();
+			numTiles = 0;
+		}
+
+		unsigned int numRows() const { return rows; }
+		unsigned int numCols() const { return cols; }
+		size_t size() const { return numCells; }
+
+		/**	Position of square (row, col) in the flat array.  Anything that
+		 *	keeps per-square data in a parallel array should index it with this.
+		 */
+		size_t index(unsigned int row, unsigned int col) const
+		{
+			return static_cast<size_t>(row) * cols + col;
+		}
+
+		SquareType get(unsigned int row, unsigned int col) const
+		{
+			return cells[index(row, col)].load(std::memory_order_acquire);
+		}
+
+		/**	The squares as plain bytes (a SquareType each), in index() order,
+		 *	followed by READ_PADDING readable bytes.  Only read them this way
+		 *	while nobody writes the grid.
+		 */
+		const uint8_t* squareBytes() const
+		{
+			static_assert(sizeof(std::atomic<SquareType>) == 1, "a square must be a single byte");
+			return reinterpret_cast<const uint8_t*>(cells.get());
+		}
+
+		static const size_t READ_PADDING = 4;
+
+		void set(unsigned int row, unsigned int col, SquareType type)
+		{
+			cells[index(row, col)].store(type, std::memory_order_release);
+			markDirty(row, col);
+		}
+
+		/**	Atomically replaces the square's type by desired if it is expected
+		 *	@return true if the swap happened
+		 */
+		bool compareExchange(unsigned int row, unsigned int col,
+							 SquareType expected, SquareType desired)
+		{
+			if (!cells[index(row, col)].compare_exchange_strong(expected, desired,
+																std::memory_order_acq_rel))
+				return false;
+			markDirty(row, col);
+			return true;
+		}
+
+		/**	Starts recording which tiles (of 2^shift x 2^shift squares) get
+		 *	written to, all of them dirty to begin with.  Until this gets
+		 *	called (after each allocate()), writes record nothing.
+		 */
+		void trackDirtyTiles(unsigned int shift)
+		{
+			tileShift = shift;
+			tileCols = ((cols - 1) >> shift) + 1;
+			numTiles = static_cast<size_t>(((rows - 1) >> shift) + 1) * tileCols;
+			dirtyTiles.reset(new std::atomic<uint8_t>[numTiles]);
+			for (size_t k=0; k<numTiles; k++)
+				dirtyTiles[k].store(1, std::memory_order_relaxed);
+		}
+
+		unsigned int tileSizeShift() const { return tileShift; }
+		unsigned int numTileCols() const { return tileCols; }
+		size_t tileCount() const { return numTiles; }
+
+		/**	@return true if the tile was written to since the last call (and
+		 *	clears its flag).  Only call this while nobody writes the grid.
+		 */
+		bool takeDirtyTile(size_t tile)
+		{
+			if (dirtyTiles[tile].load(std::memory_order_relaxed) == 0)
+				return false;
+			dirtyTiles[tile].store(0, std::memory_order_relaxed);
+			return true;
+		}
+
+	private:
+
+		//	Checks the flag before setting it, so that the workers only read
+		//	the (shared) cache line of a tile that is already dirty
+		void markDirty(unsigned int row, unsigned int col)
+		{
+			if (dirtyTiles)
+			{
+				std::atomic<uint8_t>& flag = dirtyTiles[static_cast<size_t>(row >> tileShift) * tileCols +
+														(col >> tileShift)];
+				if (flag.load(std::memory_order_relaxed) == 0)
+					flag.store(1, std::memory_order_relaxed);
+			}
+		}
+
+		unsigned int rows = 0;
+		unsigned int cols = 0;
+		size_t numCells = 0;
+		std::unique_ptr<std::atomic<SquareType>[]> cells;
+		//	one flag per tile, if trackDirtyTiles() was called
+		std::unique_ptr<std::atomic<uint8_t>[]> dirtyTiles;
+		unsigned int tileShift = 0;
+		unsigned int tileCols = 0;
+		size_t numTiles = 0;
+};
+
+#endif //	GRID_H
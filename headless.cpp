@@ -0,0 +1,56 @@
+//
+//  headless.cpp
+//  Final Project CSC412
+//
+//	Driver for the simulation engine that doesn't open a window and doesn't
+//	link with OpenGL/glut.  It runs the travelers until they have all found
+//	the exit, then reports how long that took and the resulting throughput.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+//
+#include "simulation.h"
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	//	Nobody is watching, so there is no point in slowing the travelers down
+	//	(unless --sleep says otherwise)
+	travelerSleepTime = 0;
+	parseArguments(argc, argv);
+
+	printf("grid:       %u x %u\n", numRows, numCols);
+	printf("travelers:  %u\n", numTravelers);
+	printf("workers:    %u\n", numWorkers);
+	printf("grid locks: %s\n", lockStr(lockGranularity).c_str());
+	printf("seed:       %lu\n", randomSeed);
+	printf("\n%-8s %10s %8s %10s %10s %12s %12s %12s\n",
+		   "engine", "init (s)", "solved", "ticks", "run (s)", "moves", "moves/sec", "lock bytes");
+
+	//	Same seed for every engine, so they all start from the same maze
+	for (EngineMode mode : engineModeList)
+	{
+		engineMode = mode;
+
+		chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+		initializeApplication();
+		chrono::steady_clock::time_point runTime = chrono::steady_clock::now();
+		runSimulation();
+		chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+
+		size_t lockBytes = gridLocks.memoryUsage();
+		double initElapsed = chrono::duration<double>(runTime - startTime).count();
+		double runElapsed = chrono::duration<double>(endTime - runTime).count();
+		unsigned long numMoves = numMovesDone.load();
+
+		printf("%-8s %10.3f %8u %10lu %10.3f %12lu %12.0f %12zu\n",
+			   engineStr(mode).c_str(), initElapsed, numTravelersDone, numTicksDone.load(),
+			   runElapsed, numMoves, runElapsed > 0 ? numMoves / runElapsed : 0.0, lockBytes);
+
+		cleanupSimulation();
+	}
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+//
+//  latencyHistogram.h
+//  Final Project CSC412
+//
+//	Fixed-size histogram of durations (in nanoseconds), precise to about
+//	6% at any scale:  values are binned by their power of two, and each
+//	power of two is cut into 16 equal sub-bins.  Recording a value is a
+//	few integer operations and one increment, so each worker can keep its
+//	own histogram on the hot path and merge it with the others at the end.
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+class LatencyHistogram
+{
+	public:
+
+		void record(uint64_t nanoseconds)
+		{
+			counts[binOf(nanoseconds)]++;
+			total++;
+		}
+
+		void merge(const LatencyHistogram& other)
+		{
+			for (unsigned int k=0; k<NUM_BINS; k++)
+				counts[k] += other.counts[k];
+			total += other.total;
+		}
+
+		void clear()
+		{
+			counts.fill(0);
+			total = 0;
+		}
+
+		uint64_t numSamples() const { return total; }
+
+		/**	@param fraction in [0, 1] (0.5 for the median, 0.99 for p99)
+		 *	@return an upper bound (within a sub-bin) of that quantile, in nanoseconds
+		 */
+		uint64_t quantile(double fraction) const
+		{
+			if (total == 0)
+				return 0;
+
+			uint64_t rank = static_cast<uint64_t>(fraction * (total - 1)) + 1;
+			uint64_t seen = 0;
+			for (unsigned int k=0; k<NUM_BINS; k++)
+			{
+				seen += counts[k];
+				if (seen >= rank)
+					return upperBoundOf(k);
+			}
+			return upperBoundOf(NUM_BINS - 1);
+		}
+
+	private:
+
+		static const unsigned int SUB_BITS = 4;
+		static const unsigned int NUM_SUB_BINS = 1U << SUB_BITS;
+		static const unsigned int NUM_BINS = (64 - SUB_BITS + 1) * NUM_SUB_BINS;
+
+		static unsigned int binOf(uint64_t value)
+		{
+			if (value < NUM_SUB_BINS)
+				return static_cast<unsigned int>(value);
+
+			unsigned int msb = 63 - __builtin_clzll(value);
+			unsigned int shift = msb - SUB_BITS;
+			return (shift + 1) * NUM_SUB_BINS + static_cast<unsigned int>((value >> shift) & (NUM_SUB_BINS - 1));
+		}
+
+		static uint64_t upperBoundOf(unsigned int bin)
+		{
+			if (bin < NUM_SUB_BINS)
+				return bin;
+
+			unsigned int shift = bin / NUM_SUB_BINS - 1;
+			uint64_t subBin = bin % NUM_SUB_BINS;
+			return ((NUM_SUB_BINS + subBin + 1) << shift) - 1;
+		}
+
+		std::array<uint64_t, NUM_BINS> counts{};
+		uint64_t total = 0;
+};
+
+#endif //	LATENCY_HISTOGRAM_H
@@ -0,0 +1,149 @@
+//
+//  lockManager.cpp
+//  Final Project CSC412
+//
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+//
+#include "lockManager.h"
+
+using namespace std;
+
+//	number of busy-wait iterations before a SpinLock starts yielding
+const unsigned int MAX_SPINS_BEFORE_YIELD = 64;
+
+//	waiting time of the current thread, see SpinLock::threadWaitTime()
+static thread_local uint64_t spinWaitTime = 0;
+
+void SpinLock::lockContended()
+{
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	unsigned int spins = 0;
+	do
+	{
+		while (flag.load(memory_order_relaxed))
+			backOff(spins);
+	}
+	while (flag.exchange(true, memory_order_acquire));
+
+	spinWaitTime += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count();
+}
+
+uint64_t SpinLock::threadWaitTime()
+{
+	return spinWaitTime;
+}
+
+void SpinLock::backOff(unsigned int& spins)
+{
+	if (++spins < MAX_SPINS_BEFORE_YIELD)
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+	}
+	else
+	{
+		this_thread::yield();
+	}
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark LockManager
+//-----------------------------------------------------------------------------
+#endif
+
+void LockManager::configure(LockGranularity granularity, unsigned int numRows, unsigned int numCols,
+							unsigned int tileSize, unsigned int numStripes)
+{
+	release();
+
+	mode = granularity;
+	cols = numCols;
+	tileSide = max(1U, tileSize);
+
+	switch (mode)
+	{
+		case LockGranularity::CELL:
+			lockCount = static_cast<size_t>(numRows) * numCols;
+			break;
+
+		case LockGranularity::TILE:
+			tilesPerRow = (numCols + tileSide - 1) / tileSide;
+			lockCount = ((numRows + tileSide - 1) / tileSide) * tilesPerRow;
+			break;
+
+		case LockGranularity::STRIPE:
+			lockCount = max(1U, numStripes);
+			break;
+
+		default:
+			lockCount = 1;
+			break;
+	}
+
+	if (mode == LockGranularity::CELL)
+		cellLocks.reset(new SpinLock[lockCount]);
+	else
+		paddedLocks.reset(new PaddedLock[lockCount]);
+}
+
+void LockManager::release()
+{
+	cellLocks.reset();
+	paddedLocks.reset();
+	lockCount = 0;
+}
+
+size_t LockManager::memoryUsage() const
+{
+	return lockCount * ((mode == LockGranularity::CELL) ? sizeof(SpinLock) : sizeof(PaddedLock));
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark MultiSquareLock
+//-----------------------------------------------------------------------------
+#endif
+
+void MultiSquareLock::add(unsigned int row, unsigned int col)
+{
+	if (count == capacity)
+	{
+		//	move to an array twice as big (the old one stays in the arena
+		//	until the rewind)
+		Arena& scratch = scratchArena();
+		if (overflow == nullptr)
+			scratchMark = scratch.mark();
+		size_t* bigger = static_cast<size_t*>(scratch.allocate(2 * capacity * sizeof(size_t), alignof(size_t)));
+		copy(indices(), indices() + count, bigger);
+		overflow = bigger;
+		capacity *= 2;
+	}
+	indices()[count++] = manager.lockIndex(row, col);
+}
+
+void MultiSquareLock::lockAll()
+{
+	size_t* first = indices();
+	sort(first, first + count);
+	count = unique(first, first + count) - first;
+
+	for (numLocked = 0; numLocked < count; numLocked++)
+		manager.lockAt(first[numLocked]).lock();
+}
+
+void MultiSquareLock::unlockAll()
+{
+	size_t* first = indices();
+	while (numLocked > 0)
+	{
+		numLocked--;
+		manager.lockAt(first[numLocked]).unlock();
+	}
+}
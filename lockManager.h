@@ -0,0 +1,195 @@
+//
+//  lockManager.h
+//  Final Project CSC412
+//
+//	The locks that protect the grid squares, at a granularity picked at
+//	startup:  one lock per square, one per square tile, a fixed number of
+//	hashed stripes, or a single global lock.  Whatever the granularity,
+//	every lock has an index, and locks are always acquired in increasing
+//	index order.  In CELL mode the index is the square's row-major index,
+//	so that order is the canonical (row, col) order.
+
+#ifndef LOCK_MANAGER_H
+#define LOCK_MANAGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "arena.h"
+#include "dataTypes.h"
+
+/**	One-byte spin lock.  Spins briefly, then yields the processor, so it
+ *	degrades gracefully when there are more workers than cores.
+ *	Meets the Lockable requirements (usable with std::lock_guard).
+ */
+class SpinLock
+{
+	public:
+
+		void lock()
+		{
+			if (flag.exchange(true, std::memory_order_acquire))
+				lockContended();
+		}
+
+		bool try_lock()
+		{
+			return !flag.load(std::memory_order_relaxed) &&
+				   !flag.exchange(true, std::memory_order_acquire);
+		}
+
+		void unlock()
+		{
+			flag.store(false, std::memory_order_release);
+		}
+
+		/**	Time the calling thread has spent waiting for a SpinLock held by
+		 *	someone else, since it started (uncontended locks cost nothing)
+		 *	@return the waiting time in nanoseconds
+		 */
+		static uint64_t threadWaitTime();
+
+	private:
+
+		//	slow path of lock(), out of line
+		void lockContended();
+
+		static void backOff(unsigned int& spins);
+
+		std::atomic<bool> flag{false};
+};
+
+class LockManager
+{
+	public:
+
+		/**	(Re)allocates the locks for a numRows x numCols grid
+		 *	@param tileSize side of a square tile (TILE mode only)
+		 *	@param numStripes number of hashed locks (STRIPE mode only)
+		 */
+		void configure(LockGranularity granularity, unsigned int numRows, unsigned int numCols,
+					   unsigned int tileSize, unsigned int numStripes);
+
+		void release();
+
+		LockGranularity granularity() const { return mode; }
+		size_t numLocks() const { return lockCount; }
+
+		/**	Bytes taken by the locks themselves
+		 */
+		size_t memoryUsage() const;
+
+		/**	Index of the lock that protects square (row, col).  Locks must be
+		 *	acquired in increasing index order.
+		 */
+		size_t lockIndex(unsigned int row, unsigned int col) const
+		{
+			switch (mode)
+			{
+				case LockGranularity::CELL:
+					return static_cast<size_t>(row) * cols + col;
+
+				case LockGranularity::TILE:
+					return static_cast<size_t>(row / tileSide) * tilesPerRow + col / tileSide;
+
+				case LockGranularity::STRIPE:
+					return hashSquare(static_cast<size_t>(row) * cols + col) % lockCount;
+
+				default:
+					return 0;
+			}
+		}
+
+		SpinLock& lockAt(size_t index)
+		{
+			return (mode == LockGranularity::CELL) ? cellLocks[index] : paddedLocks[index].lock;
+		}
+
+		/**	The lock that protects square (row, col)
+		 */
+		SpinLock& forSquare(unsigned int row, unsigned int col)
+		{
+			return lockAt(lockIndex(row, col));
+		}
+
+	private:
+
+		//	Locks shared by many squares are padded to a cache line each, so
+		//	that two workers using neighboring locks don't fight over the line.
+		struct alignas(64) PaddedLock
+		{
+			SpinLock lock;
+		};
+
+		static size_t hashSquare(size_t squareIndex)
+		{
+			squareIndex ^= squareIndex >> 33;
+			squareIndex *= 0xFF51AFD7ED558CCDULL;
+			squareIndex ^= squareIndex >> 33;
+			return squareIndex;
+		}
+
+		LockGranularity mode = LockGranularity::CELL;
+		unsigned int cols = 0;
+		unsigned int tileSide = 1;
+		size_t tilesPerRow = 0;
+		size_t lockCount = 0;
+		std::unique_ptr<SpinLock[]> cellLocks;
+		std::unique_ptr<PaddedLock[]> paddedLocks;
+};
+
+/**	Holds the locks of a set of squares for the duration of a scope.
+ *	The squares are added first, then lockAll() takes their locks in
+ *	increasing lock index order, skipping duplicates (several squares
+ *	can share a lock in TILE, STRIPE, and GLOBAL modes).  That order is
+ *	the same for every thread, so two MultiSquareLocks can't deadlock.
+ */
+class MultiSquareLock
+{
+	public:
+
+		explicit MultiSquareLock(LockManager& manager)
+			:	manager(manager)
+		{}
+
+		~MultiSquareLock()
+		{
+			unlockAll();
+			if (overflow != nullptr)
+				scratchArena().rewind(scratchMark);
+		}
+
+		MultiSquareLock(const MultiSquareLock&) = delete;
+		MultiSquareLock& operator=(const MultiSquareLock&) = delete;
+
+		void add(unsigned int row, unsigned int col);
+
+		void lockAll();
+
+		void unlockAll();
+
+	private:
+
+		//	Most lock sets are one or two squares (a traveler's move), so
+		//	those fit inline.  Bigger ones (a partition slide) go to the
+		//	thread's scratch arena, given back when the lock set goes away,
+		//	so they don't touch the heap either.
+		static const size_t INLINE_CAPACITY = 8;
+
+		size_t* indices()
+		{
+			return (overflow == nullptr) ? inlineIndices : overflow;
+		}
+
+		LockManager& manager;
+		size_t inlineIndices[INLINE_CAPACITY];
+		size_t* overflow = nullptr;
+		size_t capacity = INLINE_CAPACITY;
+		Arena::Mark scratchMark;
+		size_t count = 0;
+		size_t numLocked = 0;
+};
+
+#endif //	LOCK_MANAGER_H
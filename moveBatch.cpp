@@ -0,0 +1,114 @@
+//
+//  moveBatch.cpp
+//  Final Project CSC412
+//
+//	The AVX2 version is compiled for AVX2 on its own (target attribute), so
+//	the rest of the program still runs on any x86-64 processor, and on
+//	other architectures only the scalar version exists.
+
+#include "moveBatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_AVX2_VERSION 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+//	Lanes [first, batch.count), one at a time
+static void evaluateLanes(MoveBatch& batch, size_t first, const uint8_t* squares,
+						  unsigned int numRows, unsigned int numCols)
+{
+	for (size_t k=first; k<batch.count; k++)
+	{
+		//	a step off row or column 0 wraps around to a huge unsigned value
+		uint32_t row = batch.row[k] + DIRECTION_ROW_STEP[batch.dir[k]];
+		uint32_t col = batch.col[k] + DIRECTION_COL_STEP[batch.dir[k]];
+		batch.targetRow[k] = row;
+		batch.targetCol[k] = col;
+		batch.targetSquare[k] = (row < numRows && col < numCols)
+									? squares[static_cast<size_t>(row) * numCols + col]
+									: OFF_GRID;
+	}
+}
+
+static void evaluateMovesScalar(MoveBatch& batch, const uint8_t* squares,
+								unsigned int numRows, unsigned int numCols)
+{
+	evaluateLanes(batch, 0, squares, numRows, numCols);
+}
+
+#ifdef HAVE_AVX2_VERSION
+//	Eight lanes at a time.  The gather reads 4 bytes at each square and
+//	keeps the first one, so the grid must be readable 3 bytes past its end
+//	(see Grid::READ_PADDING).  A square's index must fit in an int32_t,
+//	which it does for the largest grid the arguments allow.
+__attribute__((target("avx2")))
+static void evaluateMovesAVX2(MoveBatch& batch, const uint8_t* squares,
+							  unsigned int numRows, unsigned int numCols)
+{
+	const __m256i rowSteps = _mm256_setr_epi32(1, 0, -1, 0, 0, 0, 0, 0);
+	const __m256i colSteps = _mm256_setr_epi32(0, 1, 0, -1, 0, 0, 0, 0);
+	//	unsigned comparisons, done as signed ones on biased values
+	const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000U));
+	const __m256i rowLimit = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(numRows)), bias);
+	const __m256i colLimit = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(numCols)), bias);
+	const __m256i cols = _mm256_set1_epi32(static_cast<int>(numCols));
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i offGrid = _mm256_set1_epi32(static_cast<int>(OFF_GRID));
+
+	size_t k = 0;
+	for (; k + 8 <= batch.count; k += 8)
+	{
+		__m256i dir = _mm256_load_si256(reinterpret_cast<const __m256i*>(batch.dir + k));
+		__m256i row = _mm256_add_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(batch.row + k)),
+									   _mm256_permutevar8x32_epi32(rowSteps, dir));
+		__m256i col = _mm256_add_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(batch.col + k)),
+									   _mm256_permutevar8x32_epi32(colSteps, dir));
+
+		__m256i inside = _mm256_and_si256(_mm256_cmpgt_epi32(rowLimit, _mm256_xor_si256(row, bias)),
+										  _mm256_cmpgt_epi32(colLimit, _mm256_xor_si256(col, bias)));
+		__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(row, cols), col);
+		//	the lanes outside the grid load nothing and keep OFF_GRID
+		__m256i square = _mm256_mask_i32gather_epi32(offGrid, reinterpret_cast<const int*>(squares),
+													  index, inside, 1);
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(batch.targetRow + k), row);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(batch.targetCol + k), col);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(batch.targetSquare + k),
+						   _mm256_and_si256(square, byteMask));
+	}
+	evaluateLanes(batch, k, squares, numRows, numCols);
+}
+#endif
+
+typedef void (*MoveEvaluator)(MoveBatch&, const uint8_t*, unsigned int, unsigned int);
+
+static MoveEvaluator bestEvaluator(void)
+{
+#ifdef HAVE_AVX2_VERSION
+	//	(this runs during static initialization, maybe before the
+	//	feature detection initialized itself)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return evaluateMovesAVX2;
+#endif
+	return evaluateMovesScalar;
+}
+
+static MoveEvaluator evaluator = bestEvaluator();
+
+void evaluateMoves(MoveBatch& batch, const uint8_t* squares, unsigned int numRows, unsigned int numCols)
+{
+	evaluator(batch, squares, numRows, numCols);
+}
+
+void useScalarMoves(bool scalar)
+{
+	evaluator = scalar ? evaluateMovesScalar : bestEvaluator();
+}
+
+const char* moveEvaluatorName(void)
+{
+	return (evaluator == evaluateMovesScalar) ? "scalar" : "avx2";
+}
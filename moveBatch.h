@@ -0,0 +1,57 @@
+//
+//  moveBatch.h
+//  Final Project CSC412
+//
+//	Evaluation of many moves at once.  The caller packs the head position
+//	and the direction of a run of travelers into a MoveBatch (a structure
+//	of arrays), and evaluateMoves() finds all their target squares and what
+//	is in them:  eight moves per instruction with AVX2 (the direction steps
+//	come from a lookup table, the squares from a gather), or one at a time
+//	on processors that don't have it.  The version is picked at run time.
+
+#ifndef MOVE_BATCH_H
+#define MOVE_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include "dataTypes.h"
+
+//	What evaluateMoves() reports, instead of a square type, for a target
+//	outside the grid
+const uint32_t OFF_GRID = 0xFF;
+
+/**	Moves to evaluate, one per lane.  The caller fills count and, for each
+ *	lane, id (whatever it wants to find its traveler by), row, col, and dir;
+ *	evaluateMoves() fills the targets.
+ */
+struct MoveBatch
+{
+	static constexpr size_t CAPACITY = 256;
+
+	size_t count = 0;
+	alignas(32) uint32_t id[CAPACITY];
+	alignas(32) uint32_t row[CAPACITY];
+	alignas(32) uint32_t col[CAPACITY];
+	alignas(32) uint32_t dir[CAPACITY];
+	//	the square the move goes to, and its SquareType (or OFF_GRID)
+	alignas(32) uint32_t targetRow[CAPACITY];
+	alignas(32) uint32_t targetCol[CAPACITY];
+	alignas(32) uint32_t targetSquare[CAPACITY];
+};
+
+/**	Fills the targets of the batch's moves
+ *	@param squares the grid's squares (Grid::squareBytes()), which nobody
+ *			may write while this runs
+ */
+void evaluateMoves(MoveBatch& batch, const uint8_t* squares, unsigned int numRows, unsigned int numCols);
+
+/**	Makes evaluateMoves() use the scalar version even if the processor
+ *	could do better (to compare them)
+ */
+void useScalarMoves(bool scalar);
+
+/**	@return the version evaluateMoves() uses:  "avx2" or "scalar"
+ */
+const char* moveEvaluatorName(void);
+
+#endif //	MOVE_BATCH_H
@@ -0,0 +1,85 @@
+//
+//  randomStream.h
+//  Final Project CSC412
+//
+//	Small, independent random number streams, so that threads never share
+//	a generator.  Each stream is identified by a (master seed, stream id)
+//	pair:  the same pair always produces the same sequence, whichever
+//	thread happens to draw from it.
+
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <cstdint>
+#include <limits>
+
+/**	SplitMix64 generator.  8 bytes of state, one add and a few
+ *	multiply/xor-shifts per number, and it satisfies the standard's
+ *	UniformRandomBitGenerator requirements, so <random> distributions
+ *	can use it too.
+ */
+class RandomStream
+{
+	public:
+
+		using result_type = uint64_t;
+
+		RandomStream()
+			:	state(0)
+		{}
+
+		/**	@param masterSeed the seed of the whole simulation
+		 *	@param streamId which of the streams derived from masterSeed (e.g., traveler index)
+		 */
+		RandomStream(uint64_t masterSeed, uint64_t streamId)
+			:	state(mix(masterSeed + mix(streamId + GOLDEN_GAMMA)))
+		{}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+		result_type operator()()
+		{
+			state += GOLDEN_GAMMA;
+			return mix(state);
+		}
+
+		/**	Uniform integer in [0, bound), bound > 0, using Lemire's
+		 *	multiply-shift.  The few products whose low word falls below
+		 *	2^32 mod bound would make some results more likely than others,
+		 *	so those get drawn again (rarely:  bound / 2^32 of the time).
+		 */
+		uint32_t nextBelow(uint32_t bound)
+		{
+			uint64_t product = ((*this)() >> 32) * bound;
+			if (static_cast<uint32_t>(product) < bound)
+			{
+				uint32_t threshold = (0U - bound) % bound;
+				while (static_cast<uint32_t>(product) < threshold)
+					product = ((*this)() >> 32) * bound;
+			}
+			return static_cast<uint32_t>(product >> 32);
+		}
+
+		/**	Uniform double in [0, 1)
+		 */
+		double nextUnit()
+		{
+			return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+		}
+
+	private:
+
+		static constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+		static uint64_t mix(uint64_t z)
+		{
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+
+		uint64_t state;
+};
+
+#endif //	RANDOM_STREAM_H
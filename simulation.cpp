@@ -0,0 +1,2718 @@
+//
+//  simulation.cpp
+//  Final Project CSC412
+//
+//	The simulation engine, split out of main.cpp so that it can run with or
+//	without the graphic front end.
+//
+//	This is public domain code.  By all means appropriate it and change is to your
+//	heart's content.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <random>
+#include <memory>
+#include <vector>
+
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+//
+#include "simulation.h"
+#include "latencyHistogram.h"
+#include "distanceField.h"
+#include "freeSquareMap.h"
+#include "lockManager.h"
+#include "moveBatch.h"
+#include "randomStream.h"
+#include "transport.h"
+#include "tripleBuffer.h"
+#include "workerPool.h"
+#include <thread>
+#include <unistd.h>
+#include <mutex>
+
+
+
+//	feel free to "un-use" std if this is against your beliefs.
+using namespace std;
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Private Functions' Prototypes
+//-----------------------------------------------------------------------------
+#endif
+
+GridPosition getNewFreePosition(void);
+void placeTraveler(unsigned int row, unsigned int col);
+Direction newDirection(RandomStream& rng, Direction forbiddenDir = Direction::NUM_DIRECTIONS);
+TravelerSegment newTravelerSegment(const TravelerSegment& currentSeg, RandomStream& rng, bool& canAdd);
+void generateWalls(void);
+void generatePartitions(void);
+class WorkerPool;
+void generateTiledMaze(WorkerPool& pool, vector<TravelerSegment>& headList);
+void runTickEngine(WorkerPool& pool);
+void runRegionEngine(WorkerPool& pool);
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Application-level Global Variables
+//-----------------------------------------------------------------------------
+#endif
+
+//	Don't rename any of these variables
+//-------------------------------------
+//	The state grid and its dimensions (arguments to the program)
+Grid grid;
+unsigned int numRows = 0;			//	height of the grid
+unsigned int numCols = 0;			//	width
+//	The number of traveler threads (argument to the program)
+unsigned int numTravelers = 0;		//	initial number = numTravelersDone + numLiveThreads
+unsigned int numTravelersDone = 0;
+unsigned int numLiveThreads = 0;	//	the number of live traveler threads
+//
+GridPosition exitPos;				//	location of the exit (randomly generated)
+float** travelerColor;				//	unique colors assigned to the travelers
+mutex globalMutex;
+// V5: the locks of the grid squares (one per square by default, see --locks)
+LockManager gridLocks;
+LockGranularity lockGranularity = LockGranularity::CELL;
+unsigned int lockTileSize = 8;
+unsigned int numLockStripes = 4096;
+
+//	throughput counter, reported by the headless driver
+atomic<unsigned long> numMovesDone(0);
+atomic<unsigned long> numSlidesDone(0);
+atomic<unsigned long> numTicksDone(0);
+unsigned long maxNumTicks = 0;
+
+//	Size of the worker pool that moves the travelers (0: one per core), and
+//	how many travelers a worker takes from a deque at a time
+unsigned int numWorkers = 0;
+EngineMode engineMode = EngineMode::MUTEX;
+vector<EngineMode> engineModeList;
+const size_t TRAVELER_BATCH_SIZE = 64;
+atomic<bool> stopRequested(false);
+
+//	When set, the engines time every step (two clock reads per step) into
+//	stepLatency.  The workers merge their measurements into it when
+//	runSimulation() ends.
+bool measureStepLatency = false;
+LatencyHistogram stepLatency;
+
+//	Frames for the renderer (see publishFrame).  The grid records its dirty
+//	tiles of 16 x 16 squares while publishFrames is set.
+bool publishFrames = false;
+TripleBuffer<FrameSnapshot> frameBuffer;
+const unsigned int FRAME_TILE_SHIFT = 4;
+
+//	Number of processes of a distributed run, and how they talk to each other
+unsigned int numProcesses = 2;
+TransportMode transportMode = TransportMode::SHARED_MEMORY;
+
+
+
+//
+//	all the travelers, indexed by id (see travelerStore.h)
+TravelerStore travelers;
+vector<SlidingPartition*> partitionList;
+//	index in partitionList of the partition occupying each square (or
+//	NO_PARTITION), in grid.index() order.  Kept up to date by the slides.
+unique_ptr<atomic<uint16_t>[]> partitionIdGrid;
+
+//	Owns what lives as long as the world (the partitions and their block
+//	lists), so that cleanupSimulation() frees it all with a single release
+Arena simulationArena;
+
+//	number of partitions to generate (-1:  one per lane, see generatePartitions)
+int numPartitions = -1;
+
+//	The whole grid at once from the seeded engine, or tile by tile in
+//	parallel (see generateTiledMaze)
+MazeMode mazeMode = MazeMode::CLASSIC;
+
+//	How the travelers pick their direction, and for the gradient mode the
+//	fraction of their moves that stay random (so that a traveler blocked
+//	on its shortest path eventually goes around the obstacle)
+RoutingMode routingMode = RoutingMode::RANDOM;
+double explorationRate = 0.1;
+//	distance from each square to the exit (gradient mode only)
+DistanceField exitDistance;
+//	the squares still free while initializeApplication() places the
+//	travelers (released once they are all there)
+FreeSquareMap freeSquares;
+
+//	Length of the travelers:  how many segments they start with (fewer if
+//	there is no room), how many moves it takes them to grow one more
+//	(0:  never), and the most they can have (0:  numInitialSegments if they
+//	don't grow, DEFAULT_MAX_NUM_SEGMENTS if they do)
+unsigned int numInitialSegments = 1;
+unsigned int movesPerGrowth = 0;
+unsigned int maxNumSegments = 0;
+const unsigned int DEFAULT_MAX_NUM_SEGMENTS = 32;
+
+//	travelers' sleep time between moves (in microseconds).  Feel free to adjust
+const int MIN_SLEEP_TIME = 1000;
+int travelerSleepTime = 100000;
+
+//---------------------------
+//	Random generators
+//---------------------------
+const unsigned int MAX_NUM_INITIAL_SEGMENTS = 8;
+//	The engine gets (re)seeded from randomSeed in initializeApplication, so
+//	that two runs with the same seed produce the same maze and travelers.
+//	It is only used by the (single-threaded) initialization:  once the
+//	simulation runs, each traveler draws from its own RandomStream.
+unsigned long randomSeed = 0;
+default_random_engine engine;
+uniform_int_distribution<unsigned int> unsignedNumberGenerator(0, numeric_limits<unsigned int>::max());
+uniform_int_distribution<unsigned int> segmentNumberGenerator(0, MAX_NUM_INITIAL_SEGMENTS);
+uniform_int_distribution<unsigned int> segmentDirectionGenerator(0, static_cast<unsigned int>(Direction::NUM_DIRECTIONS)-1);
+//
+//	This will produce a random bool value true/false with 50/50 equal probability.
+bernoulli_distribution headsOrTails(0.5);
+//	If we want a biased coin producing "true" 70% of the time, we would declare
+//bernoulli_distribution headsOrTails(0.7);
+//
+//	We declare the distributions here because we need them to be global, accessible
+//	from different functions, but we will only know the range they must cover after
+//	we have read the dimensions of the grid from the argument list.
+uniform_int_distribution<unsigned int> rowGenerator;
+uniform_int_distribution<unsigned int> colGenerator;
+//
+//	The tiled maze has no shared engine:  tile t draws from stream t of
+//	randomSeed + MAZE_STREAM_OFFSET (the travelers use the streams of
+//	randomSeed itself).  The tiles are mazeTileSize to twice that on a side.
+unsigned int mazeTileSize = 256;
+const uint64_t MAZE_STREAM_OFFSET = 0x6D617A65;
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Hot-path Counters
+//-----------------------------------------------------------------------------
+#endif
+
+//	Counters of one worker thread.  Only that thread writes them, with a
+//	relaxed load and store (no read-modify-write, no lock), and
+//	getSimulationStats() sums them up whenever it wants.  Each worker's
+//	counters start on their own cache line.
+struct alignas(64) WorkerCounters
+{
+	atomic<unsigned long> outcomeCount[static_cast<int>(MoveOutcome::NUM_MOVE_OUTCOMES)];
+	atomic<unsigned long> numSlideAttempts;
+	atomic<unsigned long> numSlideSuccesses;
+	atomic<unsigned long> gridLockWaitTime;
+	atomic<unsigned long> travelerLockWaitTime;
+
+	static void add(atomic<unsigned long>& counter, unsigned long amount = 1)
+	{
+		counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+	}
+};
+
+//	one per worker of the pool, allocated by initializeApplication
+unique_ptr<WorkerCounters[]> workerCounterList;
+unsigned int numWorkerCounters = 0;
+//	counters of the calling thread (nullptr if it is not a worker)
+thread_local WorkerCounters* threadCounters = nullptr;
+
+inline void countOutcome(MoveOutcome outcome)
+{
+	if (threadCounters != nullptr)
+		WorkerCounters::add(threadCounters->outcomeCount[static_cast<int>(outcome)]);
+}
+
+//	Counts a slide attempt, and passes its result through
+inline bool countSlide(bool hasSlid)
+{
+	if (threadCounters != nullptr)
+	{
+		WorkerCounters::add(threadCounters->numSlideAttempts);
+		if (hasSlid)
+			WorkerCounters::add(threadCounters->numSlideSuccesses);
+	}
+	return hasSlid;
+}
+
+//	Outcome of a move into a square that is neither free nor a partition nor the exit
+inline MoveOutcome blockedBy(SquareType type)
+{
+	return (type == SquareType::WALL) ? MoveOutcome::WALL : MoveOutcome::TRAVELER;
+}
+
+//	lock_guard for a traveler's mutex that counts the time spent waiting
+//	for it, if someone else held it
+class CountedLockGuard
+{
+	public:
+
+		explicit CountedLockGuard(mutex& lock)
+			:	lock(lock)
+		{
+			if (!lock.try_lock())
+			{
+				chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+				lock.lock();
+				if (threadCounters != nullptr)
+					WorkerCounters::add(threadCounters->travelerLockWaitTime,
+										chrono::duration_cast<chrono::nanoseconds>(
+											chrono::steady_clock::now() - startTime).count());
+			}
+		}
+
+		~CountedLockGuard()
+		{
+			lock.unlock();
+		}
+
+		CountedLockGuard(const CountedLockGuard&) = delete;
+		CountedLockGuard& operator=(const CountedLockGuard&) = delete;
+
+	private:
+
+		mutex& lock;
+};
+
+SimulationStats getSimulationStats(void)
+{
+	SimulationStats stats = {};
+	for (unsigned int w=0; w<numWorkerCounters; w++)
+	{
+		const WorkerCounters& counters = workerCounterList[w];
+		for (int k=0; k<static_cast<int>(MoveOutcome::NUM_MOVE_OUTCOMES); k++)
+		{
+			unsigned long count = counters.outcomeCount[k].load(memory_order_relaxed);
+			stats.outcomeCount[k] += count;
+			stats.numMoveAttempts += count;
+		}
+		stats.numSlideAttempts += counters.numSlideAttempts.load(memory_order_relaxed);
+		stats.numSlideSuccesses += counters.numSlideSuccesses.load(memory_order_relaxed);
+		stats.gridLockWaitTime += counters.gridLockWaitTime.load(memory_order_relaxed);
+		stats.travelerLockWaitTime += counters.travelerLockWaitTime.load(memory_order_relaxed);
+	}
+	return stats;
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Frame Snapshots
+//-----------------------------------------------------------------------------
+#endif
+
+//	Number of the last frame published, and of the last one the renderer
+//	is known to have taken
+unsigned long frameSequence = 0;
+unsigned long consumedSequence = 0;
+//	number of the frame in which each tile last changed
+vector<unsigned long> tileVersion;
+
+//	Copies the grid and the travelers into the frame buffer's free frame,
+//	and publishes it.  Only call this while no worker moves anything (at
+//	the end of a tick), holding globalMutex if the workers are running.
+//	The free frame holds an older copy of the grid, so only the tiles that
+//	changed since then get copied, and the frame lists the tiles that
+//	changed since the one the renderer has, so that it only redraws those.
+//	The copies reuse the frame's storage, so past the first few frames
+//	this allocates nothing.
+void publishFrame(void)
+{
+	//	we only publish a frame while the previous one is pending if the run
+	//	ends, so the renderer has taken either that one or the one before
+	if (!frameBuffer.isPending())
+		consumedSequence = frameSequence;
+	frameSequence++;
+
+	FrameSnapshot& frame = frameBuffer.writeBuffer();
+	unsigned long copiedSequence = frame.sequence;
+	if (frame.squareList.size() != grid.size() || frame.numCols != numCols)
+	{
+		frame.squareList.resize(grid.size());
+		copiedSequence = 0;
+	}
+	frame.sequence = frameSequence;
+	frame.baseSequence = consumedSequence;
+	frame.tick = numTicksDone.load();
+	frame.numRows = numRows;
+	frame.numCols = numCols;
+	frame.numTravelersDone = numTravelersDone;
+	frame.numLiveThreads = numLiveThreads;
+	frame.tileShift = grid.tileSizeShift();
+	frame.tileCols = grid.numTileCols();
+
+	frame.dirtyTileList.clear();
+	for (size_t t=0; t<grid.tileCount(); t++)
+	{
+		if (grid.takeDirtyTile(t))
+			tileVersion[t] = frameSequence;
+		if (tileVersion[t] > consumedSequence)
+			frame.dirtyTileList.push_back(static_cast<uint32_t>(t));
+		if (tileVersion[t] <= copiedSequence)
+			continue;
+
+		unsigned int firstRow = static_cast<unsigned int>(t / frame.tileCols) << frame.tileShift;
+		unsigned int firstCol = static_cast<unsigned int>(t % frame.tileCols) << frame.tileShift;
+		unsigned int endRow = min(numRows, firstRow + (1U << frame.tileShift));
+		unsigned int endCol = min(numCols, firstCol + (1U << frame.tileShift));
+		for (unsigned int i=firstRow; i<endRow; i++)
+		{
+			for (unsigned int j=firstCol; j<endCol; j++)
+				frame.squareList[grid.index(i, j)] = grid.get(i, j);
+		}
+	}
+
+	frame.travelerList.clear();
+	frame.segmentList.clear();
+	for (unsigned int id=0; id<travelers.size(); id++)
+	{
+		if (travelers.isDone(id))
+			continue;
+
+		TravelerFrame entry;
+		copy(travelers.rgba(id), travelers.rgba(id) + 4, entry.rgba);
+		entry.firstSegment = static_cast<unsigned int>(frame.segmentList.size());
+		entry.numSegments = travelers.numSegments(id);
+		frame.travelerList.push_back(entry);
+		for (unsigned int k=0; k<entry.numSegments; k++)
+			frame.segmentList.push_back(travelers.segment(id, k));
+	}
+
+	frameBuffer.publish();
+}
+
+const FrameSnapshot& acquireFrame(void)
+{
+	return frameBuffer.acquire();
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Mutex Engine
+//-----------------------------------------------------------------------------
+#endif
+
+//	Caller must hold the square's lock (mutex engine), or have claimed the
+//	square (lock-free engine)
+inline void setPartitionId(unsigned int row, unsigned int col, uint16_t id)
+{
+	partitionIdGrid[grid.index(row, col)].store(id, memory_order_release);
+}
+
+//	Tells the distance field (if the travelers follow one) about a slide
+//	that just took the partition's blocks one square (dr, dc)
+inline void noteSlide(const SlidingPartition& part, int dr, int dc)
+{
+	if (exitDistance.isReady())
+		exitDistance.noteSlide(part.blockList, dr, dc);
+}
+
+//	Whether square (row, col) is one of the partition's blocks.  The blocks
+//	form a straight line, listed in order, so this is a bounding-box test.
+//	Caller must hold the partition's blockListMutex (or be the only writer).
+bool partitionOccupies(const SlidingPartition& part, unsigned int row, unsigned int col)
+{
+	const GridPosition& first = part.blockList.front();
+	const GridPosition& last = part.blockList.back();
+	return row >= first.row && row <= last.row && col >= first.col && col <= last.col;
+}
+
+//	Slides a partition one square in the direction it got pushed from
+//	square (pushedRow, pushedCol).  This is a multi-square transaction:  it
+//	takes the partition's own mutex, then the locks of every square the
+//	partition occupies and every square it would move into, all at once and
+//	in lock order (see MultiSquareLock).  Lock hierarchy for the whole
+//	engine:  traveler or partition mutex first, then square locks in
+//	increasing index order, and never a traveler/partition mutex while
+//	holding a square lock.
+bool trySlidePartition(SlidingPartition* part, Direction dir,
+					   unsigned int pushedRow, unsigned int pushedCol)
+{
+	lock_guard<mutex> plock(part->blockListMutex);
+
+	// the partition may have moved since the traveler saw it
+	if (!partitionOccupies(*part, pushedRow, pushedCol))
+		return false;
+
+    int dr = rowStep(dir);
+    int dc = colStep(dir);
+
+	// lock the union of the squares the partition occupies and the ones it
+	// would move into
+	MultiSquareLock locks(gridLocks);
+    for (auto& pos : part->blockList)
+    {
+        int nr = pos.row + dr;
+        int nc = pos.col + dc;
+
+        if (nr < 0 || nr >= (int)numRows ||
+            nc < 0 || nc >= (int)numCols)
+            return false;
+
+		locks.add(pos.row, pos.col);
+		locks.add(nr, nc);
+    }
+	locks.lockAll();
+
+    // check if all blocks can move
+    for (auto& pos : part->blockList)
+    {
+        if (grid.get(pos.row + dr, pos.col + dc) != SquareType::FREE_SQUARE)
+            return false;
+    }
+
+    // clear old positions
+    for (auto& pos : part->blockList)
+    {
+        grid.set(pos.row, pos.col, SquareType::FREE_SQUARE);
+        setPartitionId(pos.row, pos.col, NO_PARTITION);
+    }
+
+    // move blocks
+    for (auto& pos : part->blockList)
+    {
+        pos.row += dr;
+        pos.col += dc;
+        setPartitionId(pos.row, pos.col, part->index);
+        grid.set(pos.row, pos.col,
+                 part->isVertical ? SquareType::VERTICAL_PARTITION
+                                  : SquareType::HORIZONTAL_PARTITION);
+    }
+	noteSlide(*part, dr, dc);
+	numSlidesDone.fetch_add(1, memory_order_relaxed);
+
+    return true;
+}
+
+//	Finds the partition that has a block at square (row, col), or nullptr,
+//	in constant time through partitionIdGrid.  The answer can be stale by
+//	the time the caller uses it, which is why the slide functions check
+//	again that the pushed square belongs to the partition.
+SlidingPartition* findPartition(unsigned int row, unsigned int col)
+{
+	uint16_t id = partitionIdGrid[grid.index(row, col)].load(memory_order_acquire);
+	return (id == NO_PARTITION) ? nullptr : partitionList[id];
+}
+
+//	Direction of a traveler's next move:  random, or down the distance
+//	field in gradient mode (except for a fraction explorationRate of the
+//	moves, or when no neighbor is closer to the exit)
+Direction chooseDirection(unsigned int index)
+{
+	RandomStream& rng = travelers.rng(index);
+	if (routingMode == RoutingMode::GRADIENT && rng.nextUnit() >= explorationRate)
+	{
+		const TravelerSegment& head = travelers.head(index);
+		Direction dir = exitDistance.downhill(head.row, head.col, rng);
+		if (dir != Direction::NUM_DIRECTIONS)
+			return dir;
+	}
+	return newDirection(rng);
+}
+
+//	Direction a traveler's new head points to:  back to the old head, the
+//	way every segment points to the next one
+inline Direction oppositeDirection(Direction dir)
+{
+	return static_cast<Direction>((static_cast<unsigned int>(dir) + 2) %
+								  static_cast<unsigned int>(Direction::NUM_DIRECTIONS));
+}
+
+//	Whether the next move of a traveler makes it grow by one segment
+//	(instead of dropping its tail)
+inline bool growsOnMove(unsigned int index)
+{
+	return movesPerGrowth > 0 && travelers.numSegments(index) < travelers.maxSegments() &&
+		   (travelers.numMoves(index) + 1) % movesPerGrowth == 0;
+}
+
+//	Moves the head of a traveler into square (row, col), which the caller
+//	already set to TRAVELER, and frees the square its tail leaves, if any.
+//	The caller must be the only thread that can touch that square.
+void advanceTraveler(unsigned int index, unsigned int row, unsigned int col, Direction dir)
+{
+	TravelerSegment tail = travelers.tail(index);
+	if (!travelers.advanceHead(index, {row, col, oppositeDirection(dir)}, growsOnMove(index)))
+		grid.set(tail.row, tail.col, SquareType::FREE_SQUARE);
+}
+
+//	Removes one segment of a traveler that has reached the exit, tail first
+//	so that the fade out is visible.  Returns true once the head is gone too.
+bool fadeOutTraveler(unsigned int index)
+{
+	// lock traveler first, then grid squares
+	CountedLockGuard tlock(travelers.lock(index));
+
+	if (travelers.numSegments(index) > 1)
+	{
+		// remove last segment
+		TravelerSegment tail = travelers.popTail(index);
+
+		// clear grid square of removed segment
+		lock_guard<SpinLock> cellLock(gridLocks.forSquare(tail.row, tail.col));
+		grid.set(tail.row, tail.col, SquareType::FREE_SQUARE);
+		return false;
+	}
+
+	//  remove head
+	{
+		TravelerSegment& head = travelers.head(index);
+
+		lock_guard<SpinLock> cellLock(gridLocks.forSquare(head.row, head.col));
+		grid.set(head.row, head.col, SquareType::FREE_SQUARE);
+	}
+
+	// mark traveler done
+	{
+		lock_guard<mutex> glock(globalMutex);
+		travelers.setState(index, TravelerState::DONE);
+		numTravelersDone++;
+	}
+	return true;
+}
+
+//	Performs one move of a traveler (what used to be one iteration of the
+//	traveler thread's loop).  Returns true once the traveler has left the grid.
+bool stepTravelerLocked(unsigned int index)
+{
+	if (travelers.isExiting(index))
+		return fadeOutTraveler(index);
+
+    Direction dir;
+    int newRow, newCol;
+
+    {
+        CountedLockGuard tlock(travelers.lock(index));
+        TravelerSegment& head = travelers.head(index);
+
+        dir = chooseDirection(index);
+        newRow = head.row;
+        newCol = head.col;
+
+        newRow += rowStep(dir);
+        newCol += colStep(dir);
+    }
+
+    if (newRow < 0 || newRow >= (int)numRows ||
+        newCol < 0 || newCol >= (int)numCols)
+    {
+        countOutcome(MoveOutcome::OUT_OF_BOUNDS);
+        return false;
+    }
+
+    SquareType targetSquare;
+
+    {
+        lock_guard<SpinLock> cellLock(gridLocks.forSquare(newRow, newCol));
+
+        targetSquare = grid.get(newRow, newCol);
+
+        if (targetSquare == SquareType::WALL ||
+            targetSquare == SquareType::TRAVELER)
+        {
+            countOutcome(blockedBy(targetSquare));
+            return false;
+        }
+    }
+
+	// EC 4.1: from now on the traveler fades out, one segment per step
+	if (targetSquare == SquareType::EXIT)
+	{
+		countOutcome(MoveOutcome::EXIT);
+		travelers.setState(index, TravelerState::EXITING);
+		return fadeOutTraveler(index);
+	}
+
+    if (targetSquare == SquareType::VERTICAL_PARTITION ||
+        targetSquare == SquareType::HORIZONTAL_PARTITION)
+    {
+        SlidingPartition* part = findPartition(newRow, newCol);
+
+        // the partition moved away since we looked
+        if (part == nullptr)
+        {
+            countOutcome(MoveOutcome::LOST_RACE);
+            return false;
+        }
+        if (!countSlide(trySlidePartition(part, dir, newRow, newCol)))
+        {
+            countOutcome(MoveOutcome::PARTITION_BLOCKED);
+            return false;
+        }
+    }
+
+    {
+        // lock traveler to safely read current position
+        CountedLockGuard tlock(travelers.lock(index));
+        TravelerSegment tail = travelers.tail(index);
+
+        // lock the square the head enters and the one the tail leaves
+        // (if it doesn't grow), in lock order (they may share a lock)
+        MultiSquareLock gridLock(gridLocks);
+        if (!growsOnMove(index))
+            gridLock.add(tail.row, tail.col);
+        gridLock.add(newRow, newCol);
+        gridLock.lockAll();
+
+        // the square was checked without holding this lock, so another
+        // traveler or a partition may have moved in since then
+        if (grid.get(newRow, newCol) != SquareType::FREE_SQUARE)
+        {
+            countOutcome(MoveOutcome::LOST_RACE);
+            return false;
+        }
+
+        grid.set(newRow, newCol, SquareType::TRAVELER);
+        advanceTraveler(index, newRow, newCol, dir);
+    }
+    countOutcome(MoveOutcome::MOVED);
+    numMovesDone.fetch_add(1, memory_order_relaxed);
+
+    return false;
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Lock-free Engine
+//-----------------------------------------------------------------------------
+#endif
+
+//	In the lock-free engine (--engine cas) the grid squares themselves are
+//	the synchronization:  a traveler or partition block only ever enters a
+//	square by swapping it from FREE_SQUARE, and only its owner ever sets
+//	one of its squares back to FREE_SQUARE.  Two travelers can therefore
+//	never end up in the same square, and no step waits for another.
+
+//	Same as trySlidePartition, without locks.  The destination squares are
+//	claimed one at a time;  if one is taken, the ones already claimed are
+//	given back and the slide fails.
+bool trySlidePartitionLockFree(SlidingPartition* part, Direction dir,
+							   unsigned int pushedRow, unsigned int pushedCol)
+{
+	//	only one traveler at a time gets to push a given partition
+	if (part->isSliding.exchange(true, memory_order_acquire))
+		return false;
+
+	//	the partition may have moved since the traveler saw it
+	if (!partitionOccupies(*part, pushedRow, pushedCol))
+	{
+		part->isSliding.store(false, memory_order_release);
+		return false;
+	}
+
+	int dr = rowStep(dir);
+	int dc = colStep(dir);
+
+	const SquareType partType = part->isVertical ? SquareType::VERTICAL_PARTITION
+												 : SquareType::HORIZONTAL_PARTITION;
+	const size_t numBlocks = part->blockList.size();
+	size_t numClaimed = 0;
+	bool canMove = true;
+
+	for (; numClaimed < numBlocks && canMove; numClaimed++)
+	{
+		const GridPosition& pos = part->blockList[numClaimed];
+		int nr = pos.row + dr;
+		int nc = pos.col + dc;
+
+		canMove = nr >= 0 && nr < (int)numRows && nc >= 0 && nc < (int)numCols &&
+				  grid.compareExchange(nr, nc, SquareType::FREE_SQUARE, partType);
+		if (canMove)
+			setPartitionId(nr, nc, part->index);
+	}
+
+	if (!canMove)
+	{
+		//	the last block examined failed, give back the ones before it
+		for (size_t k=0; k+1 < numClaimed; k++)
+		{
+			const GridPosition& pos = part->blockList[k];
+			setPartitionId(pos.row + dr, pos.col + dc, NO_PARTITION);
+			grid.set(pos.row + dr, pos.col + dc, SquareType::FREE_SQUARE);
+		}
+	}
+	else
+	{
+		for (auto& pos : part->blockList)
+		{
+			setPartitionId(pos.row, pos.col, NO_PARTITION);
+			grid.set(pos.row, pos.col, SquareType::FREE_SQUARE);
+			pos.row += dr;
+			pos.col += dc;
+		}
+		noteSlide(*part, dr, dc);
+	}
+
+	part->isSliding.store(false, memory_order_release);
+	if (canMove)
+		numSlidesDone.fetch_add(1, memory_order_relaxed);
+	return canMove;
+}
+
+//	fadeOutTraveler without locks:  the squares of a traveler are only
+//	ever written by the worker that steps it.
+bool fadeOutTravelerLockFree(unsigned int index)
+{
+	if (travelers.numSegments(index) > 1)
+	{
+		TravelerSegment tail = travelers.popTail(index);
+		grid.set(tail.row, tail.col, SquareType::FREE_SQUARE);
+		return false;
+	}
+
+	TravelerSegment& head = travelers.head(index);
+	grid.set(head.row, head.col, SquareType::FREE_SQUARE);
+
+	lock_guard<mutex> glock(globalMutex);
+	travelers.setState(index, TravelerState::DONE);
+	numTravelersDone++;
+	return true;
+}
+
+//	stepTravelerLocked without locks:  the destination square is claimed
+//	with a compare-and-swap before the source square is released.
+bool stepTravelerLockFree(unsigned int index)
+{
+	if (travelers.isExiting(index))
+		return fadeOutTravelerLockFree(index);
+
+	const TravelerSegment& head = travelers.head(index);
+	Direction dir = chooseDirection(index);
+	int newRow = head.row;
+	int newCol = head.col;
+
+	newRow += rowStep(dir);
+	newCol += colStep(dir);
+
+	if (newRow < 0 || newRow >= (int)numRows ||
+		newCol < 0 || newCol >= (int)numCols)
+	{
+		countOutcome(MoveOutcome::OUT_OF_BOUNDS);
+		return false;
+	}
+
+	SquareType targetSquare = grid.get(newRow, newCol);
+
+	if (targetSquare == SquareType::WALL ||
+		targetSquare == SquareType::TRAVELER)
+	{
+		countOutcome(blockedBy(targetSquare));
+		return false;
+	}
+
+	if (targetSquare == SquareType::EXIT)
+	{
+		countOutcome(MoveOutcome::EXIT);
+		travelers.setState(index, TravelerState::EXITING);
+		return fadeOutTravelerLockFree(index);
+	}
+
+	if (targetSquare == SquareType::VERTICAL_PARTITION ||
+		targetSquare == SquareType::HORIZONTAL_PARTITION)
+	{
+		SlidingPartition* part = findPartition(newRow, newCol);
+
+		if (part == nullptr)
+		{
+			countOutcome(MoveOutcome::LOST_RACE);
+			return false;
+		}
+		if (!countSlide(trySlidePartitionLockFree(part, dir, newRow, newCol)))
+		{
+			countOutcome(MoveOutcome::PARTITION_BLOCKED);
+			return false;
+		}
+	}
+
+	//	claim the destination first, then release the source
+	if (!grid.compareExchange(newRow, newCol, SquareType::FREE_SQUARE, SquareType::TRAVELER))
+	{
+		countOutcome(MoveOutcome::LOST_RACE);
+		return false;
+	}
+
+	advanceTraveler(index, newRow, newCol, dir);
+	countOutcome(MoveOutcome::MOVED);
+	numMovesDone.fetch_add(1, memory_order_relaxed);
+
+	return false;
+}
+
+//	Moves a traveler once with whichever engine was selected
+bool stepTraveler(unsigned int index)
+{
+	if (engineMode == EngineMode::CAS)
+		return stepTravelerLockFree(index);
+	else
+		return stepTravelerLocked(index);
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Worker Pool Scheduling
+//-----------------------------------------------------------------------------
+#endif
+
+//	Measurements of one worker:  points the thread's counters to the
+//	worker's slot for the duration of the run, and keeps its own step
+//	latency histogram, merged into the global one once the worker is done.
+struct WorkerMeasures
+{
+	LatencyHistogram latency;
+	uint64_t initialWaitTime = SpinLock::threadWaitTime();
+
+	explicit WorkerMeasures(unsigned int workerIndex)
+	{
+		threadCounters = (workerIndex < numWorkerCounters) ? &workerCounterList[workerIndex] : nullptr;
+	}
+
+	static uint64_t now()
+	{
+		return chrono::duration_cast<chrono::nanoseconds>(
+					chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//	Brings the worker's grid lock wait time up to date (SpinLock keeps its own)
+	void publish()
+	{
+		if (threadCounters != nullptr)
+			threadCounters->gridLockWaitTime.store(SpinLock::threadWaitTime() - initialWaitTime,
+												   memory_order_relaxed);
+	}
+
+	void merge()
+	{
+		publish();
+		threadCounters = nullptr;
+		lock_guard<mutex> glock(globalMutex);
+		stepLatency.merge(latency);
+	}
+};
+
+//	Bookkeeping done by the last worker to reach the end of a tick, whatever
+//	the engine:  counts the tick, repairs the distance field around the
+//	partitions that slid, sleeps travelerSleepTime, and decides whether
+//	there will be another tick.
+//	Returns the number of travelers still on the grid, or 0 if the run is over.
+unsigned int finishTick(void)
+{
+	numTicksDone.fetch_add(1);
+	if (exitDistance.isReady())
+		exitDistance.repair(grid);
+	if (travelerSleepTime > 0)
+		usleep(travelerSleepTime);
+
+	lock_guard<mutex> glock(globalMutex);
+	unsigned int numLeft = numTravelers - numTravelersDone;
+	bool keepGoing = !stopRequested.load() && numLeft > 0 &&
+					 (maxNumTicks == 0 || numTicksDone.load() < maxNumTicks);
+
+	//	no copy while the renderer hasn't drawn the previous frame, but
+	//	always one of the final state
+	if (publishFrames && (!frameBuffer.isPending() || !keepGoing))
+		publishFrame();
+
+	return keepGoing ? numLeft : 0;
+}
+
+//	Travelers are no longer one thread each:  they are work items (indices
+//	into travelers) spread over the per-worker deques of a fixed pool.
+//	In each tick, every worker pops batches of travelers from its own deque
+//	and moves each of them once, stealing from the other deques when its
+//	own runs dry.  Travelers still on the grid go into the worker's list for
+//	the next tick.  A barrier separates the ticks;  the last worker to reach
+//	it sleeps travelerSleepTime, which paces the travelers as before.
+void travelerWorker(unsigned int workerIndex, vector<WorkDeque>& deques,
+					Barrier& tickBarrier, atomic<unsigned int>& numPending, bool& isRunning)
+{
+	const unsigned int numDeques = static_cast<unsigned int>(deques.size());
+	vector<unsigned int> batch;
+	vector<unsigned int> nextTick;
+	batch.reserve(TRAVELER_BATCH_SIZE);
+	WorkerMeasures measures(workerIndex);
+
+	{
+		lock_guard<mutex> glock(globalMutex);
+		numLiveThreads++;
+	}
+
+	while (isRunning)
+	{
+		//	Step phase:  move every traveler still on the grid once
+		unsigned int victim = workerIndex;
+		while (numPending.load(memory_order_acquire) > 0)
+		{
+			batch.clear();
+			if (deques[workerIndex].popBatch(batch, TRAVELER_BATCH_SIZE) == 0)
+			{
+				//	try to steal from the other workers, round-robin
+				for (unsigned int k=1; k<numDeques && batch.empty(); k++)
+				{
+					victim = (victim + 1) % numDeques;
+					if (victim != workerIndex)
+						deques[victim].stealBatch(batch, TRAVELER_BATCH_SIZE);
+				}
+				if (batch.empty())
+				{
+					this_thread::yield();
+					continue;
+				}
+			}
+
+			for (unsigned int index : batch)
+			{
+				uint64_t startTime = measureStepLatency ? WorkerMeasures::now() : 0;
+				if (!stepTraveler(index))
+					nextTick.push_back(index);
+				if (measureStepLatency)
+					measures.latency.record(WorkerMeasures::now() - startTime);
+			}
+			numPending.fetch_sub(static_cast<unsigned int>(batch.size()), memory_order_acq_rel);
+		}
+		measures.publish();
+
+		//	End of the tick
+		tickBarrier.arriveAndWait([&]{
+			unsigned int numLeft = finishTick();
+			isRunning = numLeft > 0;
+			numPending.store(numLeft);
+		});
+
+		//	Only the barrier's completion writes isRunning, so every worker
+		//	sees the same value here (numPending may already be going down
+		//	again if another worker started the next tick)
+		if (isRunning)
+		{
+			for (unsigned int index : nextTick)
+				deques[workerIndex].push(index);
+		}
+		nextTick.clear();
+	}
+
+	measures.merge();
+	{
+		lock_guard<mutex> glock(globalMutex);
+		numLiveThreads--;
+	}
+}
+
+void runSimulation(void)
+{
+	WorkerPool pool(numWorkers);
+	if (engineMode == EngineMode::TICK)
+	{
+		runTickEngine(pool);
+		return;
+	}
+	if (engineMode == EngineMode::REGION)
+	{
+		runRegionEngine(pool);
+		return;
+	}
+
+	vector<WorkDeque> deques(pool.size());
+	Barrier tickBarrier(pool.size());
+	atomic<unsigned int> numPending(numTravelers - numTravelersDone);
+	bool isRunning = true;
+
+	//	deal the travelers to the workers in contiguous runs of ids, so that
+	//	each worker streams through its own part of the traveler arrays
+	for (unsigned int k=0; k<numTravelers; k++)
+		deques[static_cast<uint64_t>(k) * pool.size() / numTravelers].push(k);
+
+	pool.run([&](unsigned int workerIndex) {
+		travelerWorker(workerIndex, deques, tickBarrier, numPending, isRunning);
+	});
+}
+
+void stopSimulation(void)
+{
+	stopRequested.store(true);
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Tick Engine
+//-----------------------------------------------------------------------------
+#endif
+
+//	In the tick engine (--engine tick) every traveler still on the grid gets
+//	one step per tick, and a tick has three phases separated by barriers:
+//	  1. propose (parallel):  each traveler draws a direction and looks at
+//	     its target square.  Nobody writes the grid during this phase, so
+//	     everyone sees it as it was at the start of the tick.  A traveler that
+//	     wants a free square bids for it:  the square's claim keeps the
+//	     smallest traveler index that asked for it.
+//	  2. slide (serial, run by the last worker to reach the barrier):  pushes
+//	     on partitions, in traveler index order.  A partition only slides
+//	     into squares that are free and that no traveler bid for.
+//	  3. commit (parallel):  the winner of each square moves in.  The squares
+//	     written in this phase all belong to a single traveler, so the writes
+//	     never collide.
+//	None of this depends on which worker steps which traveler, or on timing,
+//	so a given seed always produces the same run, with any number of workers.
+
+//	What a traveler decided to do during the propose phase
+enum class TickAction : uint8_t
+{
+	//	stays put (wall, other traveler, edge of the grid)
+	STAY,
+	//	moves into a free square, if it wins the square's claim
+	MOVE,
+	//	pushes a partition, then moves into the square the partition left
+	PUSH,
+	//	is leaving through the exit, one segment per tick
+	FADE
+};
+
+struct TickProposal
+{
+	unsigned int row;
+	unsigned int col;
+	Direction dir;
+	TickAction action;
+};
+
+//	claim of a square that no traveler bid for
+const uint32_t NO_CLAIM = numeric_limits<uint32_t>::max();
+
+//	State shared by the workers of the tick engine
+struct TickState
+{
+	//	one bid per grid square, in grid.index() order
+	unique_ptr<atomic<uint32_t>[]> squareClaims;
+	//	one per traveler, in id order
+	vector<TickProposal> proposalList;
+	//	travelers that pushed a partition this tick, one list per worker
+	vector<vector<unsigned int> > pushList;
+	bool isRunning;
+};
+
+//	Propose phase for a run of travelers:  draws their directions, has
+//	evaluateMoves() look at all their target squares at once, then bids
+//	for a square or pushes a partition for each of them, in order.
+//	Nobody writes the grid during this phase.
+void proposeTicks(const unsigned int* indexList, size_t count, TickState& state,
+				  vector<unsigned int>& pushes, MoveBatch& batch)
+{
+	batch.count = 0;
+	for (size_t k=0; k<count; k++)
+	{
+		unsigned int index = indexList[k];
+		TickProposal& proposal = state.proposalList[index];
+
+		if (travelers.isExiting(index))
+		{
+			proposal.action = TickAction::FADE;
+			continue;
+		}
+		proposal.action = TickAction::STAY;
+
+		const TravelerSegment& head = travelers.head(index);
+		batch.id[batch.count] = index;
+		batch.row[batch.count] = head.row;
+		batch.col[batch.count] = head.col;
+		batch.dir[batch.count] = static_cast<uint32_t>(chooseDirection(index));
+		batch.count++;
+	}
+
+	evaluateMoves(batch, grid.squareBytes(), numRows, numCols);
+
+	for (size_t k=0; k<batch.count; k++)
+	{
+		unsigned int index = batch.id[k];
+		TickProposal& proposal = state.proposalList[index];
+
+		if (batch.targetSquare[k] == OFF_GRID)
+		{
+			countOutcome(MoveOutcome::OUT_OF_BOUNDS);
+			continue;
+		}
+
+		proposal.row = batch.targetRow[k];
+		proposal.col = batch.targetCol[k];
+		proposal.dir = static_cast<Direction>(batch.dir[k]);
+
+		SquareType targetSquare = static_cast<SquareType>(batch.targetSquare[k]);
+		switch (targetSquare)
+		{
+			case SquareType::FREE_SQUARE:
+			{
+				//	keep the smallest bid
+				atomic<uint32_t>& claim = state.squareClaims[grid.index(proposal.row, proposal.col)];
+				uint32_t current = claim.load(memory_order_relaxed);
+				while (index < current &&
+					   !claim.compare_exchange_weak(current, index, memory_order_relaxed))
+					;
+				proposal.action = TickAction::MOVE;
+				break;
+			}
+
+			case SquareType::EXIT:
+				//	as in the other engines, the fade out starts right away
+				countOutcome(MoveOutcome::EXIT);
+				travelers.setState(index, TravelerState::EXITING);
+				proposal.action = TickAction::FADE;
+				break;
+
+			case SquareType::VERTICAL_PARTITION:
+			case SquareType::HORIZONTAL_PARTITION:
+				proposal.action = TickAction::PUSH;
+				pushes.push_back(index);
+				break;
+
+			default:
+				countOutcome(blockedBy(targetSquare));
+				break;
+		}
+	}
+}
+
+//	Slides a partition one square (dr, dc) if all the squares it would move
+//	into are free.  No synchronization at all:  the caller must be the only
+//	thread that can touch the squares involved.
+bool slidePartitionUnsynchronized(SlidingPartition& part, int dr, int dc)
+{
+	for (auto& pos : part.blockList)
+	{
+		int nr = pos.row + dr;
+		int nc = pos.col + dc;
+
+		if (nr < 0 || nr >= (int)numRows || nc < 0 || nc >= (int)numCols ||
+			grid.get(nr, nc) != SquareType::FREE_SQUARE)
+			return false;
+	}
+
+	const SquareType partType = part.isVertical ? SquareType::VERTICAL_PARTITION
+												: SquareType::HORIZONTAL_PARTITION;
+	for (auto& pos : part.blockList)
+	{
+		grid.set(pos.row, pos.col, SquareType::FREE_SQUARE);
+		setPartitionId(pos.row, pos.col, NO_PARTITION);
+	}
+	for (auto& pos : part.blockList)
+	{
+		pos.row += dr;
+		pos.col += dc;
+		setPartitionId(pos.row, pos.col, part.index);
+		grid.set(pos.row, pos.col, partType);
+	}
+	noteSlide(part, dr, dc);
+	numSlidesDone.fetch_add(1, memory_order_relaxed);
+	return true;
+}
+
+//	Slide phase for one push.  Only ever runs on one thread, between the
+//	propose and commit phases, so it needs no lock.
+//	On success the pusher gets the claim of the square it pushed.
+void slidePartitionTick(unsigned int index, TickState& state)
+{
+	const TickProposal& proposal = state.proposalList[index];
+	SlidingPartition* part = findPartition(proposal.row, proposal.col);
+
+	//	an earlier push this tick may have moved the partition away
+	if (part == nullptr)
+		return;
+
+	int dr = rowStep(proposal.dir);
+	int dc = colStep(proposal.dir);
+
+	//	travelers' bids come first
+	for (auto& pos : part->blockList)
+	{
+		int nr = pos.row + dr;
+		int nc = pos.col + dc;
+
+		if (nr >= 0 && nr < (int)numRows && nc >= 0 && nc < (int)numCols &&
+			state.squareClaims[grid.index(nr, nc)].load(memory_order_relaxed) != NO_CLAIM)
+		{
+			countSlide(false);
+			return;
+		}
+	}
+
+	if (countSlide(slidePartitionUnsynchronized(*part, dr, dc)))
+		state.squareClaims[grid.index(proposal.row, proposal.col)].store(index, memory_order_relaxed);
+}
+
+//	Commit phase for one traveler (numMoves counts the successful moves).
+//	Returns true once the traveler has left the grid.
+bool commitTick(unsigned int index, TickState& state, unsigned long& numMoves)
+{
+	const TickProposal& proposal = state.proposalList[index];
+
+	if (proposal.action == TickAction::FADE)
+		return fadeOutTravelerLockFree(index);
+
+	if (proposal.action == TickAction::STAY)
+		return false;
+
+	//	a lost bid, or a push that didn't go through
+	atomic<uint32_t>& claim = state.squareClaims[grid.index(proposal.row, proposal.col)];
+	if (claim.load(memory_order_relaxed) != index)
+	{
+		countOutcome(proposal.action == TickAction::PUSH ? MoveOutcome::PARTITION_BLOCKED
+														 : MoveOutcome::LOST_RACE);
+		return false;
+	}
+
+	//	the winner is the only one to reset the claim, and the losers only
+	//	compare it to their own index, so the order doesn't matter
+	claim.store(NO_CLAIM, memory_order_relaxed);
+
+	grid.set(proposal.row, proposal.col, SquareType::TRAVELER);
+	advanceTraveler(index, proposal.row, proposal.col, proposal.dir);
+	countOutcome(MoveOutcome::MOVED);
+	numMoves++;
+
+	return false;
+}
+
+//	Each worker steps a fixed, contiguous range of travelers, so that the
+//	per-worker push lists come out in traveler index order when read in
+//	worker order.
+void tickWorker(unsigned int workerIndex, unsigned int numWorkersInPool,
+				TickState& state, Barrier& tickBarrier)
+{
+	vector<unsigned int> activeList;
+	vector<unsigned int>& pushes = state.pushList[workerIndex];
+	WorkerMeasures measures(workerIndex);
+
+	unsigned int first = static_cast<unsigned int>(static_cast<uint64_t>(numTravelers) * workerIndex / numWorkersInPool);
+	unsigned int last = static_cast<unsigned int>(static_cast<uint64_t>(numTravelers) * (workerIndex+1) / numWorkersInPool);
+	for (unsigned int k=first; k<last; k++)
+	{
+		if (!travelers.isDone(k))
+			activeList.push_back(k);
+	}
+	vector<uint64_t> proposeTime(activeList.size());
+	unique_ptr<MoveBatch> batch(new MoveBatch);
+
+	{
+		lock_guard<mutex> glock(globalMutex);
+		numLiveThreads++;
+	}
+
+	while (state.isRunning)
+	{
+		//	Propose phase, one batch of travelers at a time (each traveler
+		//	is charged an even share of its batch's time)
+		pushes.clear();
+		for (size_t first=0; first<activeList.size(); first+=MoveBatch::CAPACITY)
+		{
+			size_t count = min(MoveBatch::CAPACITY, activeList.size() - first);
+			uint64_t startTime = measureStepLatency ? WorkerMeasures::now() : 0;
+			proposeTicks(activeList.data() + first, count, state, pushes, *batch);
+			if (measureStepLatency)
+			{
+				uint64_t share = (WorkerMeasures::now() - startTime) / count;
+				fill(proposeTime.begin() + first, proposeTime.begin() + first + count, share);
+			}
+		}
+
+		//	Slide phase
+		tickBarrier.arriveAndWait([&]{
+			for (auto& workerPushes : state.pushList)
+				for (unsigned int index : workerPushes)
+					slidePartitionTick(index, state);
+		});
+
+		//	Commit phase
+		unsigned long numMoves = 0;
+		size_t numKept = 0;
+		for (size_t k=0; k<activeList.size(); k++)
+		{
+			//	a traveler's step is its propose and commit work together
+			uint64_t startTime = measureStepLatency ? WorkerMeasures::now() : 0;
+			unsigned int index = activeList[k];
+			bool isGone = commitTick(index, state, numMoves);
+			if (measureStepLatency)
+				measures.latency.record(proposeTime[k] + WorkerMeasures::now() - startTime);
+			if (!isGone)
+			{
+				proposeTime[numKept] = proposeTime[k];
+				activeList[numKept++] = index;
+			}
+		}
+		activeList.resize(numKept);
+		numMovesDone.fetch_add(numMoves, memory_order_relaxed);
+		measures.publish();
+
+		//	End of the tick
+		tickBarrier.arriveAndWait([&]{
+			state.isRunning = finishTick() > 0;
+		});
+	}
+
+	measures.merge();
+	{
+		lock_guard<mutex> glock(globalMutex);
+		numLiveThreads--;
+	}
+}
+
+void runTickEngine(WorkerPool& pool)
+{
+	TickState state;
+	state.squareClaims.reset(new atomic<uint32_t>[grid.size()]);
+	for (size_t k=0; k<grid.size(); k++)
+		state.squareClaims[k].store(NO_CLAIM, memory_order_relaxed);
+	state.proposalList.resize(numTravelers);
+	state.pushList.resize(pool.size());
+	state.isRunning = numTravelersDone < numTravelers && !stopRequested.load();
+
+	Barrier tickBarrier(pool.size());
+	pool.run([&](unsigned int workerIndex) {
+		tickWorker(workerIndex, pool.size(), state, tickBarrier);
+	});
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Region Engine
+//-----------------------------------------------------------------------------
+#endif
+
+//	In the region engine (--engine region) the grid is cut into horizontal
+//	bands of rows, one per worker, and each worker owns the travelers whose
+//	head is in its band.  A worker is the only thread that reads or writes
+//	the squares of its band during a tick, so a move that stays inside the
+//	band needs no synchronization at all, not even an atomic operation.
+//	A move or partition slide that would touch another band gets queued in
+//	the worker's outbox instead.  At the end of the tick the last worker to
+//	reach the barrier applies all the outboxes, in worker order, and hands
+//	travelers that crossed a border over to the inbox of their new owner.
+//	Since the bands share the one grid, no halo copy is needed:  the
+//	neighbors' border rows are only read by that serial handoff phase.
+
+//	A move that crosses a band border, waiting for the end of the tick (or,
+//	if isFade is set, the removal of a fading traveler's segment that is in
+//	another band, at (row, col))
+struct RegionHandoff
+{
+	unsigned int index;
+	unsigned int row;
+	unsigned int col;
+	Direction dir;
+	bool isFade;
+};
+
+//	State shared by the workers of the region engine
+struct RegionState
+{
+	//	band b is rows [bandFirstRow[b], bandFirstRow[b+1])
+	vector<unsigned int> bandFirstRow;
+	//	band of each row
+	vector<unsigned int> bandOfRow;
+	//	one per band
+	vector<vector<RegionHandoff> > outboxList;
+	vector<vector<unsigned int> > inboxList;
+	bool isRunning;
+};
+
+//	Moves the head of a traveler into square (row, col), which must be free
+void moveTravelerHead(unsigned int index, unsigned int row, unsigned int col, Direction dir)
+{
+	grid.set(row, col, SquareType::TRAVELER);
+	advanceTraveler(index, row, col, dir);
+}
+
+//	Whether sliding the partition by dr rows keeps it, before and after, in the band
+bool partitionStaysInBand(const SlidingPartition& part, int dr, unsigned int band,
+						  const RegionState& state)
+{
+	int firstRow = static_cast<int>(part.blockList.front().row);
+	int lastRow = static_cast<int>(part.blockList.back().row);
+	return min(firstRow, firstRow + dr) >= static_cast<int>(state.bandFirstRow[band]) &&
+		   max(lastRow, lastRow + dr) < static_cast<int>(state.bandFirstRow[band+1]);
+}
+
+//	fadeOutTravelerLockFree for a traveler of the given band.  A traveler's
+//	body may trail into another band, and the square of a segment there
+//	only gets freed in the handoff phase.
+bool fadeOutInRegion(unsigned int index, unsigned int band, RegionState& state)
+{
+	TravelerSegment tail = travelers.tail(index);
+	if (state.bandOfRow[tail.row] != band)
+	{
+		state.outboxList[band].push_back({index, tail.row, tail.col, tail.dir, true});
+		return false;
+	}
+	return fadeOutTravelerLockFree(index);
+}
+
+//	Performs one move of a traveler of the given band, or queues it in the
+//	band's outbox if it would leave the band.
+//	Returns true once the traveler has left the grid.
+bool stepTravelerInRegion(unsigned int index, unsigned int band, RegionState& state,
+						  unsigned long& numMoves)
+{
+	if (travelers.isExiting(index))
+		return fadeOutInRegion(index, band, state);
+
+	const TravelerSegment& head = travelers.head(index);
+	Direction dir = chooseDirection(index);
+	int newRow = head.row;
+	int newCol = head.col;
+
+	newRow += rowStep(dir);
+	newCol += colStep(dir);
+
+	if (newRow < 0 || newRow >= (int)numRows ||
+		newCol < 0 || newCol >= (int)numCols)
+	{
+		countOutcome(MoveOutcome::OUT_OF_BOUNDS);
+		return false;
+	}
+
+	//	so does a move that would free the tail's square in another band
+	//	(the outcome of a queued move gets counted when it is applied)
+	if (state.bandOfRow[newRow] != band ||
+		(!growsOnMove(index) && state.bandOfRow[travelers.tail(index).row] != band))
+	{
+		state.outboxList[band].push_back({index, (unsigned int) newRow, (unsigned int) newCol, dir, false});
+		return false;
+	}
+
+	SquareType targetSquare = grid.get(newRow, newCol);
+	switch (targetSquare)
+	{
+		case SquareType::FREE_SQUARE:
+			break;
+
+		case SquareType::EXIT:
+			countOutcome(MoveOutcome::EXIT);
+			travelers.setState(index, TravelerState::EXITING);
+			return fadeOutInRegion(index, band, state);
+
+		case SquareType::VERTICAL_PARTITION:
+		case SquareType::HORIZONTAL_PARTITION:
+		{
+			SlidingPartition* part = findPartition(newRow, newCol);
+			int dr = rowStep(dir);
+			int dc = colStep(dir);
+
+			if (part != nullptr && !partitionStaysInBand(*part, dr, band, state))
+			{
+				state.outboxList[band].push_back({index, (unsigned int) newRow, (unsigned int) newCol, dir, false});
+				return false;
+			}
+			if (part == nullptr || !countSlide(slidePartitionUnsynchronized(*part, dr, dc)))
+			{
+				countOutcome(MoveOutcome::PARTITION_BLOCKED);
+				return false;
+			}
+			break;
+		}
+
+		default:
+			countOutcome(blockedBy(targetSquare));
+			return false;
+	}
+
+	moveTravelerHead(index, newRow, newCol, dir);
+	countOutcome(MoveOutcome::MOVED);
+	numMoves++;
+	return false;
+}
+
+//	Applies one queued move.  Only ever runs on one thread, while all the
+//	workers wait at the barrier, so it may touch any band.
+void applyHandoff(const RegionHandoff& handoff, RegionState& state)
+{
+	if (handoff.isFade)
+	{
+		fadeOutTravelerLockFree(handoff.index);
+		return;
+	}
+
+	SquareType targetSquare = grid.get(handoff.row, handoff.col);
+	switch (targetSquare)
+	{
+		case SquareType::FREE_SQUARE:
+			break;
+
+		case SquareType::EXIT:
+			//	the traveler stays with its owner while it fades out
+			countOutcome(MoveOutcome::EXIT);
+			travelers.setState(handoff.index, TravelerState::EXITING);
+			fadeOutTravelerLockFree(handoff.index);
+			return;
+
+		case SquareType::VERTICAL_PARTITION:
+		case SquareType::HORIZONTAL_PARTITION:
+		{
+			SlidingPartition* part = findPartition(handoff.row, handoff.col);
+			int dr = rowStep(handoff.dir);
+			int dc = colStep(handoff.dir);
+			if (part == nullptr || !countSlide(slidePartitionUnsynchronized(*part, dr, dc)))
+			{
+				countOutcome(MoveOutcome::PARTITION_BLOCKED);
+				return;
+			}
+			break;
+		}
+
+		default:
+			countOutcome(blockedBy(targetSquare));
+			return;
+	}
+
+	unsigned int oldBand = state.bandOfRow[travelers.head(handoff.index).row];
+	moveTravelerHead(handoff.index, handoff.row, handoff.col, handoff.dir);
+	countOutcome(MoveOutcome::MOVED);
+	numMovesDone.fetch_add(1, memory_order_relaxed);
+
+	unsigned int newBand = state.bandOfRow[handoff.row];
+	if (newBand != oldBand)
+		state.inboxList[newBand].push_back(handoff.index);
+}
+
+void regionWorker(unsigned int band, RegionState& state, Barrier& tickBarrier)
+{
+	const unsigned int numBands = static_cast<unsigned int>(state.outboxList.size());
+	vector<unsigned int> ownedList;
+	WorkerMeasures measures(band);
+
+	if (band < numBands)
+	{
+		for (unsigned int id=0; id<travelers.size(); id++)
+		{
+			if (!travelers.isDone(id) && state.bandOfRow[travelers.head(id).row] == band)
+				ownedList.push_back(id);
+		}
+	}
+
+	{
+		lock_guard<mutex> glock(globalMutex);
+		numLiveThreads++;
+	}
+
+	while (state.isRunning)
+	{
+		//	Local phase:  (workers beyond the number of bands have nothing to do)
+		if (band < numBands)
+		{
+			unsigned long numMoves = 0;
+			size_t numKept = 0;
+			for (unsigned int index : ownedList)
+			{
+				uint64_t startTime = measureStepLatency ? WorkerMeasures::now() : 0;
+				if (!stepTravelerInRegion(index, band, state, numMoves))
+					ownedList[numKept++] = index;
+				if (measureStepLatency)
+					measures.latency.record(WorkerMeasures::now() - startTime);
+			}
+			ownedList.resize(numKept);
+			numMovesDone.fetch_add(numMoves, memory_order_relaxed);
+		}
+		measures.publish();
+
+		//	Handoff phase, then the end of the tick
+		tickBarrier.arriveAndWait([&]{
+			for (auto& outbox : state.outboxList)
+				for (const RegionHandoff& handoff : outbox)
+					applyHandoff(handoff, state);
+			state.isRunning = finishTick() > 0;
+		});
+
+		if (band < numBands)
+		{
+			//	drop the travelers that left the band or the grid during the
+			//	handoff phase, and take in the ones that entered it
+			vector<RegionHandoff>& outbox = state.outboxList[band];
+			if (!outbox.empty())
+			{
+				size_t numKept = 0;
+				for (unsigned int index : ownedList)
+				{
+					if (!travelers.isDone(index) && state.bandOfRow[travelers.head(index).row] == band)
+						ownedList[numKept++] = index;
+				}
+				ownedList.resize(numKept);
+				outbox.clear();
+			}
+
+			vector<unsigned int>& inbox = state.inboxList[band];
+			ownedList.insert(ownedList.end(), inbox.begin(), inbox.end());
+			inbox.clear();
+		}
+	}
+
+	measures.merge();
+	{
+		lock_guard<mutex> glock(globalMutex);
+		numLiveThreads--;
+	}
+}
+
+//	Cuts the grid into numBands bands of (almost) the same height
+void splitIntoBands(RegionState& state, unsigned int numBands)
+{
+	state.bandFirstRow.resize(numBands + 1);
+	for (unsigned int b=0; b<=numBands; b++)
+		state.bandFirstRow[b] = static_cast<unsigned int>(static_cast<uint64_t>(numRows) * b / numBands);
+	state.bandOfRow.resize(numRows);
+	for (unsigned int b=0; b<numBands; b++)
+		for (unsigned int row=state.bandFirstRow[b]; row<state.bandFirstRow[b+1]; row++)
+			state.bandOfRow[row] = b;
+	state.outboxList.resize(numBands);
+	state.inboxList.resize(numBands);
+	state.isRunning = numTravelersDone < numTravelers && !stopRequested.load();
+}
+
+void runRegionEngine(WorkerPool& pool)
+{
+	RegionState state;
+	splitIntoBands(state, min(pool.size(), numRows));
+
+	Barrier tickBarrier(pool.size());
+	pool.run([&](unsigned int workerIndex) {
+		regionWorker(workerIndex, state, tickBarrier);
+	});
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Distributed Engine
+//-----------------------------------------------------------------------------
+#endif
+
+//	In a distributed run (see distributed.cpp) each process, or rank, owns
+//	one band of rows, exactly like a worker of the region engine, and steps
+//	the travelers of its band with the same code, on a single thread.  Every
+//	rank has a copy of the whole world, but only the squares of its own band
+//	are up to date.  A tick takes two all-to-all exchanges:
+//	  1. the moves that leave a band are sent, as requests, to the rank that
+//	     owns the target square, which applies them in rank order;
+//	  2. that rank answers each request, and the sender frees the square of
+//	     each traveler that got accepted (which now belongs to the receiver).
+//	The second exchange also carries each rank's counters, so that all the
+//	ranks agree on when to stop.  A partition that spans two bands never
+//	slides, since no rank owns all of its squares.
+
+//	Counters of one rank, since the start of the run
+struct RankHeader
+{
+	uint64_t numTravelersDone;
+	uint64_t numMoves;
+	uint64_t numSlides;
+	uint64_t isStopping;
+};
+
+//	A traveler asking to move into another rank's band.  It carries the
+//	traveler's random stream, which the receiver takes over.
+struct MoveRequestRecord
+{
+	uint32_t index;
+	uint32_t row;
+	uint32_t col;
+	uint32_t dir;
+	RandomStream rng;
+};
+
+//	Answer to a move request:  a MoveOutcome (MOVED if the receiver took
+//	the traveler over, EXIT if the traveler starts fading out where it is)
+struct MoveReplyRecord
+{
+	uint32_t index;
+	uint32_t reply;
+};
+
+//	State of a traveler and a partition, sent to rank 0 at the end of the run
+struct TravelerRecord
+{
+	uint32_t index;
+	uint32_t row;
+	uint32_t col;
+	uint32_t dir;
+	//	a TravelerState
+	uint32_t state;
+};
+
+struct PartitionRecord
+{
+	uint32_t index;
+	uint32_t row;
+	uint32_t col;
+};
+
+template <typename T>
+void appendRecord(vector<char>& message, const T& record)
+{
+	const char* bytes = reinterpret_cast<const char*>(&record);
+	message.insert(message.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T readRecord(const vector<char>& message, size_t& offset)
+{
+	T record;
+	memcpy(&record, message.data() + offset, sizeof(T));
+	offset += sizeof(T);
+	return record;
+}
+
+size_t maxRankMessageSize(void)
+{
+	//	requests only come from a band's border rows, at most one per
+	//	traveler, so at most one per column
+	size_t tickSize = sizeof(RankHeader) + numCols * max(sizeof(MoveRequestRecord), sizeof(MoveReplyRecord));
+	size_t gatherSize = sizeof(RankHeader) + 2 * sizeof(uint32_t) + numTravelers * sizeof(TravelerRecord) +
+						partitionList.size() * sizeof(PartitionRecord);
+	return max(tickSize, gatherSize);
+}
+
+//	Rank 0 rebuilds the whole world from its own state and what the other
+//	ranks sent, so that the result can be checked and reported.
+void gatherDistributedWorld(const MessageList& incoming)
+{
+	//	clear everything that moves;  the walls and the exit never change
+	for (unsigned int i=0; i<numRows; i++)
+	{
+		for (unsigned int j=0; j<numCols; j++)
+		{
+			SquareType type = grid.get(i, j);
+			if (type == SquareType::TRAVELER || type == SquareType::VERTICAL_PARTITION ||
+				type == SquareType::HORIZONTAL_PARTITION)
+				grid.set(i, j, SquareType::FREE_SQUARE);
+			setPartitionId(i, j, NO_PARTITION);
+		}
+	}
+
+	numTravelersDone = 0;
+	unsigned long numMoves = numMovesDone, numSlides = numSlidesDone;
+	for (unsigned int r=1; r<incoming.size(); r++)
+	{
+		size_t offset = 0;
+		RankHeader header = readRecord<RankHeader>(incoming[r], offset);
+		numMoves += header.numMoves;
+		numSlides += header.numSlides;
+
+		uint32_t numTravelerRecords = readRecord<uint32_t>(incoming[r], offset);
+		for (uint32_t k=0; k<numTravelerRecords; k++)
+		{
+			TravelerRecord record = readRecord<TravelerRecord>(incoming[r], offset);
+			travelers.head(record.index) = {record.row, record.col, static_cast<Direction>(record.dir)};
+			travelers.setState(record.index, static_cast<TravelerState>(record.state));
+		}
+
+		uint32_t numPartitionRecords = readRecord<uint32_t>(incoming[r], offset);
+		for (uint32_t k=0; k<numPartitionRecords; k++)
+		{
+			PartitionRecord record = readRecord<PartitionRecord>(incoming[r], offset);
+			SlidingPartition& part = *partitionList[record.index];
+			int dr = static_cast<int>(record.row) - static_cast<int>(part.blockList[0].row);
+			int dc = static_cast<int>(record.col) - static_cast<int>(part.blockList[0].col);
+			for (auto& pos : part.blockList)
+			{
+				pos.row += dr;
+				pos.col += dc;
+			}
+		}
+	}
+
+	for (auto& part : partitionList)
+	{
+		for (auto& pos : part->blockList)
+		{
+			setPartitionId(pos.row, pos.col, part->index);
+			grid.set(pos.row, pos.col, part->isVertical ? SquareType::VERTICAL_PARTITION
+														: SquareType::HORIZONTAL_PARTITION);
+		}
+	}
+	for (unsigned int id=0; id<travelers.size(); id++)
+	{
+		if (travelers.isDone(id))
+			numTravelersDone++;
+		else
+			for (unsigned int k=0; k<travelers.numSegments(id); k++)
+				grid.set(travelers.segment(id, k).row, travelers.segment(id, k).col, SquareType::TRAVELER);
+	}
+
+	numMovesDone = numMoves;
+	numSlidesDone = numSlides;
+}
+
+void runDistributedRank(Transport& transport)
+{
+	const unsigned int myRank = transport.rank();
+	const unsigned int numRanks = transport.numRanks();
+
+	RegionState state;
+	splitIntoBands(state, numRanks);
+	//	each rank is a single worker, and counts into the first slot
+	threadCounters = &workerCounterList[0];
+
+	vector<unsigned int> ownedList;
+	vector<unsigned int> finishedList;
+	for (unsigned int id=0; id<travelers.size(); id++)
+	{
+		if (!travelers.isDone(id) && state.bandOfRow[travelers.head(id).row] == myRank)
+			ownedList.push_back(id);
+	}
+
+	MessageList outgoing, incoming;
+	while (state.isRunning)
+	{
+		//	Local phase, as in the region engine
+		unsigned long numMoves = 0;
+		size_t numKept = 0;
+		for (unsigned int index : ownedList)
+		{
+			if (stepTravelerInRegion(index, myRank, state, numMoves))
+				finishedList.push_back(index);
+			else
+				ownedList[numKept++] = index;
+		}
+		ownedList.resize(numKept);
+		numMovesDone.fetch_add(numMoves, memory_order_relaxed);
+
+		//	Exchange 1:  requests.  A push on a partition that doesn't fit in
+		//	this band also lands in the outbox:  it is simply denied.
+		clearMessages(outgoing, numRanks);
+		vector<RegionHandoff>& outbox = state.outboxList[myRank];
+		for (const RegionHandoff& handoff : outbox)
+		{
+			unsigned int owner = state.bandOfRow[handoff.row];
+			if (owner != myRank)
+				appendRecord(outgoing[owner], MoveRequestRecord{handoff.index, handoff.row, handoff.col,
+										static_cast<uint32_t>(handoff.dir), travelers.rng(handoff.index)});
+			else
+			{
+				countSlide(false);
+				countOutcome(MoveOutcome::PARTITION_BLOCKED);
+			}
+		}
+		outbox.clear();
+		transport.exchange(outgoing, incoming);
+
+		//	Apply the requests this rank got, in rank order
+		clearMessages(outgoing, numRanks);
+		RankHeader myHeader = {numTravelersDone, numMovesDone.load(), numSlidesDone.load(),
+							   stopRequested.load() ? 1U : 0U};
+		for (unsigned int r=0; r<numRanks; r++)
+		{
+			if (r == myRank)
+				continue;
+			appendRecord(outgoing[r], myHeader);
+
+			for (size_t offset=0; offset < incoming[r].size(); )
+			{
+				MoveRequestRecord request = readRecord<MoveRequestRecord>(incoming[r], offset);
+				Direction dir = static_cast<Direction>(request.dir);
+				SquareType targetSquare = grid.get(request.row, request.col);
+				MoveOutcome reply = blockedBy(targetSquare);
+
+				switch (targetSquare)
+				{
+					case SquareType::FREE_SQUARE:
+						reply = MoveOutcome::MOVED;
+						break;
+
+					//	the traveler starts fading out where it is
+					case SquareType::EXIT:
+						reply = MoveOutcome::EXIT;
+						break;
+
+					case SquareType::VERTICAL_PARTITION:
+					case SquareType::HORIZONTAL_PARTITION:
+					{
+						SlidingPartition* part = findPartition(request.row, request.col);
+						int dr = rowStep(dir);
+						int dc = colStep(dir);
+						reply = MoveOutcome::PARTITION_BLOCKED;
+						if (part != nullptr && partitionStaysInBand(*part, dr, myRank, state) &&
+							countSlide(slidePartitionUnsynchronized(*part, dr, dc)))
+							reply = MoveOutcome::MOVED;
+						break;
+					}
+
+					default:
+						break;
+				}
+
+				if (reply == MoveOutcome::MOVED)
+				{
+					travelers.head(request.index) = {request.row, request.col, oppositeDirection(dir)};
+					travelers.rng(request.index) = request.rng;
+					grid.set(request.row, request.col, SquareType::TRAVELER);
+					ownedList.push_back(request.index);
+				}
+				appendRecord(outgoing[r], MoveReplyRecord{request.index, static_cast<uint32_t>(reply)});
+			}
+		}
+
+		//	Exchange 2:  replies and counters
+		transport.exchange(outgoing, incoming);
+
+		RankHeader total = myHeader;
+		vector<unsigned int> leftList;
+		for (unsigned int r=0; r<numRanks; r++)
+		{
+			if (r == myRank)
+				continue;
+
+			size_t offset = 0;
+			RankHeader header = readRecord<RankHeader>(incoming[r], offset);
+			total.numTravelersDone += header.numTravelersDone;
+			total.isStopping |= header.isStopping;
+
+			while (offset < incoming[r].size())
+			{
+				MoveReplyRecord record = readRecord<MoveReplyRecord>(incoming[r], offset);
+				MoveOutcome reply = static_cast<MoveOutcome>(record.reply);
+				countOutcome(reply);
+				if (reply == MoveOutcome::MOVED)
+				{
+					TravelerSegment& head = travelers.head(record.index);
+					grid.set(head.row, head.col, SquareType::FREE_SQUARE);
+					leftList.push_back(record.index);
+					numMovesDone.fetch_add(1, memory_order_relaxed);
+				}
+				else if (reply == MoveOutcome::EXIT)
+				{
+					travelers.setState(record.index, TravelerState::EXITING);
+					if (fadeOutTravelerLockFree(record.index))
+					{
+						leftList.push_back(record.index);
+						finishedList.push_back(record.index);
+					}
+				}
+			}
+		}
+
+		//	drop the travelers that now belong to another rank (or are gone)
+		if (!leftList.empty())
+		{
+			sort(leftList.begin(), leftList.end());
+			numKept = 0;
+			for (unsigned int index : ownedList)
+			{
+				if (!binary_search(leftList.begin(), leftList.end(), index))
+					ownedList[numKept++] = index;
+			}
+			ownedList.resize(numKept);
+		}
+
+		//	every rank computed the same totals, so they all stop together
+		numTicksDone.fetch_add(1);
+		//	a rank only sees the slides in its own band:  the partitions of
+		//	the other bands stay where it last saw them
+		if (exitDistance.isReady())
+			exitDistance.repair(grid);
+		if (travelerSleepTime > 0)
+			usleep(travelerSleepTime);
+		state.isRunning = !total.isStopping && total.numTravelersDone < numTravelers &&
+						  (maxNumTicks == 0 || numTicksDone.load() < maxNumTicks);
+	}
+
+	//	Final gather:  every rank sends rank 0 the travelers it owns or saw
+	//	leave, and the partitions that lie in its band
+	clearMessages(outgoing, numRanks);
+	if (myRank != 0)
+	{
+		vector<char>& message = outgoing[0];
+		appendRecord(message, RankHeader{numTravelersDone, numMovesDone.load(), numSlidesDone.load(), 0});
+
+		appendRecord(message, static_cast<uint32_t>(ownedList.size() + finishedList.size()));
+		for (const vector<unsigned int>* list : {&ownedList, &finishedList})
+		{
+			for (unsigned int index : *list)
+			{
+				const TravelerSegment& head = travelers.head(index);
+				appendRecord(message, TravelerRecord{index, head.row, head.col, static_cast<uint32_t>(head.dir),
+													 static_cast<uint32_t>(travelers.state(index))});
+			}
+		}
+
+		vector<PartitionRecord> partRecords;
+		for (auto& part : partitionList)
+		{
+			if (partitionStaysInBand(*part, 0, myRank, state))
+				partRecords.push_back({part->index, part->blockList[0].row, part->blockList[0].col});
+		}
+		appendRecord(message, static_cast<uint32_t>(partRecords.size()));
+		for (const PartitionRecord& record : partRecords)
+			appendRecord(message, record);
+	}
+	transport.exchange(outgoing, incoming);
+	threadCounters = nullptr;
+
+	if (myRank == 0)
+		gatherDistributedWorld(incoming);
+}
+
+//==================================================================================
+//
+//	This is a function that you have to edit and add to.
+//
+//==================================================================================
+
+
+void initializeApplication(void)
+{
+	numTravelersDone = 0;
+	numLiveThreads = 0;
+	numMovesDone = 0;
+	numSlidesDone = 0;
+	numTicksDone.store(0);
+	stopRequested = false;
+	stepLatency.clear();
+
+	//	one set of counters per worker the pool will have
+	numWorkerCounters = (numWorkers > 0) ? numWorkers : max(1U, thread::hardware_concurrency());
+	workerCounterList.reset(new WorkerCounters[numWorkerCounters]());
+
+	//	Initialize some random generators
+	rowGenerator = uniform_int_distribution<unsigned int>(0, numRows-1);
+	colGenerator = uniform_int_distribution<unsigned int>(0, numCols-1);
+
+	//	Allocate the grid (one block, all free squares)
+	grid.allocate(numRows, numCols, SquareType::FREE_SQUARE);
+	if (publishFrames)
+	{
+		grid.trackDirtyTiles(FRAME_TILE_SHIFT);
+		tileVersion.assign(grid.tileCount(), 0);
+	}
+	partitionIdGrid.reset(new atomic<uint16_t>[grid.size()]);
+	for (size_t k=0; k<grid.size(); k++)
+		partitionIdGrid[k].store(NO_PARTITION, memory_order_relaxed);
+
+	// V5: allocate the grid square locks (the lock-free engine has none)
+	if (engineMode == EngineMode::MUTEX)
+		gridLocks.configure(lockGranularity, numRows, numCols, lockTileSize, numLockStripes);
+
+
+	//---------------------------------------------------------------
+	//	All the code below to be replaced/removed
+	//	I initialize the grid's pixels to have something to look at
+	//---------------------------------------------------------------
+	//	Yes, I am using the C random generator after ranting in class that the C random
+	//	generator was junk.  Here I am not using it to produce "serious" data (as in a
+	//	real simulation), only wall/partition location and some color
+	srand((unsigned int) randomSeed);
+	engine.seed(static_cast<default_random_engine::result_type>(randomSeed));
+
+	//	generate a random exit (the grid is still empty)
+	exitPos.row = rowGenerator(engine);
+	exitPos.col = colGenerator(engine);
+	grid.set(exitPos.row, exitPos.col, SquareType::EXIT);
+
+	//	Generate walls and partitions (and, for the tiled maze, the
+	//	travelers' heads), then the map of the squares left for the travelers
+	WorkerPool pool(numWorkers);
+	vector<TravelerSegment> headList;
+	if (mazeMode == MazeMode::TILED)
+		generateTiledMaze(pool, headList);
+	else
+	{
+		generateWalls();
+		generatePartitions();
+		freeSquares.build(grid, pool);
+	}
+
+	//	the distance field goes around the partitions, and follows them as
+	//	they slide (see finishTick)
+	if (routingMode == RoutingMode::GRADIENT)
+		exitDistance.compute(grid, exitPos, pool);
+	
+	//	the colors only live until the travelers have copied them
+	Arena colorArena;
+	travelerColor = createTravelerColors(numTravelers, colorArena);
+
+
+
+		// create all travelers
+	unsigned int segmentCapacity = maxNumSegments;
+	if (segmentCapacity == 0)
+		segmentCapacity = (movesPerGrowth > 0) ? DEFAULT_MAX_NUM_SEGMENTS : 1;
+	travelers.allocate(numTravelers, max(segmentCapacity, numInitialSegments));
+	for (unsigned int k = 0; k < numTravelers; k++)
+	{
+		TravelerSegment seg;
+		if (k < headList.size() && headList[k].row < numRows)
+			seg = headList[k];
+		else
+		{
+			GridPosition pos = getNewFreePosition();
+			Direction dir = static_cast<Direction>(segmentDirectionGenerator(engine));
+			seg = {pos.row, pos.col, dir};
+		}
+		travelers.add(seg, RandomStream(randomSeed, k), travelerColor[k]);
+
+		placeTraveler(seg.row, seg.col);
+
+		//	the rest of the body, for as long as there is room behind the tail
+		bool canAdd = true;
+		while (canAdd && travelers.numSegments(k) < numInitialSegments)
+		{
+			TravelerSegment newSeg = newTravelerSegment(travelers.tail(k), travelers.rng(k), canAdd);
+			if (canAdd)
+				travelers.pushTail(k, newSeg);
+		}
+	}
+
+
+	colorArena.release();
+	travelerColor = nullptr;
+	freeSquares.release();
+
+	//	so that the renderer has something to draw before the first tick
+	if (publishFrames)
+		publishFrame();
+}
+
+bool checkGridConsistency(string& problem)
+{
+	char buffer[128];
+	size_t numTravelerSquares = 0, numPartitionSquares = 0;
+
+	for (unsigned int id=0; id<travelers.size(); id++)
+	{
+		lock_guard<mutex> tlock(travelers.lock(id));
+		if (travelers.isDone(id))
+			continue;
+
+		for (unsigned int k=0; k<travelers.numSegments(id); k++)
+		{
+			const TravelerSegment& seg = travelers.segment(id, k);
+			if (grid.get(seg.row, seg.col) != SquareType::TRAVELER)
+			{
+				snprintf(buffer, sizeof(buffer), "traveler %u has a segment on a %s square at (%u, %u)",
+						 id, typeStr(grid.get(seg.row, seg.col)).c_str(), seg.row, seg.col);
+				problem = buffer;
+				return false;
+			}
+			//	and each segment points to the next one
+			if (k+1 < travelers.numSegments(id))
+			{
+				const TravelerSegment& next = travelers.segment(id, k+1);
+				int dr = rowStep(seg.dir);
+				int dc = colStep(seg.dir);
+				if (static_cast<int>(next.row) != static_cast<int>(seg.row) + dr ||
+					static_cast<int>(next.col) != static_cast<int>(seg.col) + dc)
+				{
+					snprintf(buffer, sizeof(buffer), "traveler %u has a broken body after segment %u at (%u, %u)",
+							 id, k, seg.row, seg.col);
+					problem = buffer;
+					return false;
+				}
+			}
+			numTravelerSquares++;
+		}
+	}
+
+	for (auto& part : partitionList)
+	{
+		SquareType partType = part->isVertical ? SquareType::VERTICAL_PARTITION
+											   : SquareType::HORIZONTAL_PARTITION;
+		for (auto& pos : part->blockList)
+		{
+			if (grid.get(pos.row, pos.col) != partType)
+			{
+				snprintf(buffer, sizeof(buffer), "partition block on a %s square at (%u, %u)",
+						 typeStr(grid.get(pos.row, pos.col)).c_str(), pos.row, pos.col);
+				problem = buffer;
+				return false;
+			}
+			if (partitionIdGrid[grid.index(pos.row, pos.col)].load() != part->index)
+			{
+				snprintf(buffer, sizeof(buffer), "partition %u is missing from the square index at (%u, %u)",
+						 part->index, pos.row, pos.col);
+				problem = buffer;
+				return false;
+			}
+			numPartitionSquares++;
+		}
+	}
+
+	//	and nothing else on the grid claims to be a traveler or a partition
+	for (unsigned int i=0; i<numRows; i++)
+	{
+		for (unsigned int j=0; j<numCols; j++)
+		{
+			SquareType type = grid.get(i, j);
+			if (type == SquareType::TRAVELER)
+				numTravelerSquares--;
+			else if (type == SquareType::VERTICAL_PARTITION || type == SquareType::HORIZONTAL_PARTITION)
+				numPartitionSquares--;
+			else if (partitionIdGrid[grid.index(i, j)].load() != NO_PARTITION)
+			{
+				snprintf(buffer, sizeof(buffer), "square index has a stale partition at (%u, %u)", i, j);
+				problem = buffer;
+				return false;
+			}
+		}
+	}
+	if (numTravelerSquares != 0 || numPartitionSquares != 0)
+	{
+		problem = "the grid has traveler or partition squares that nobody owns (or owners sharing one)";
+		return false;
+	}
+
+	return true;
+}
+
+bool checkDistanceField(string& problem)
+{
+	if (!exitDistance.isReady())
+		return true;
+
+	DistanceField fresh;
+	WorkerPool pool(numWorkers);
+	fresh.compute(grid, exitPos, pool);
+	for (unsigned int i=0; i<numRows; i++)
+	{
+		for (unsigned int j=0; j<numCols; j++)
+		{
+			if (exitDistance.distance(i, j) != fresh.distance(i, j))
+			{
+				char buffer[128];
+				snprintf(buffer, sizeof(buffer), "distance %u at (%u, %u), %u from scratch",
+						 exitDistance.distance(i, j), i, j, fresh.distance(i, j));
+				problem = buffer;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void cleanupSimulation(void)
+{
+	//	Free allocated resource before leaving (not absolutely needed, but
+	//	just nicer.  Also, if you crash there, you know something is wrong
+	//	in your code.
+	grid.release();
+	partitionIdGrid.reset();
+	workerCounterList.reset();
+	numWorkerCounters = 0;
+
+	gridLocks.release();
+
+	travelers.release();
+	partitionList.clear();
+	simulationArena.release();
+	exitDistance.release();
+}
+
+//------------------------------------------------------
+#if 0
+#pragma mark -
+#pragma mark Generation Helper Functions
+#endif
+//------------------------------------------------------
+
+//	Puts a traveler's segment on a free square during the initialization
+void placeTraveler(unsigned int row, unsigned int col)
+{
+	grid.set(row, col, SquareType::TRAVELER);
+	freeSquares.markTaken(grid.index(row, col));
+}
+
+//	A free square drawn uniformly from freeSquares, however few are left.
+//	The cap on the number of travelers leaves room for walls and
+//	partitions, but a dense enough maze can still fill the grid, so running
+//	out of squares ends the program.
+GridPosition getNewFreePosition(void)
+{
+	if (freeSquares.count() == 0)
+	{
+		fprintf(stderr, "the maze leaves no free square for traveler %u of %u "
+						"(fewer travelers, or a bigger grid, would fit)\n",
+				travelers.size() + 1, numTravelers);
+		exit(1);
+	}
+
+	uniform_int_distribution<size_t> rankGenerator(0, freeSquares.count() - 1);
+	size_t index = freeSquares.select(rankGenerator(engine));
+
+	GridPosition pos;
+	pos.row = static_cast<unsigned int>(index / numCols);
+	pos.col = static_cast<unsigned int>(index % numCols);
+	return pos;
+}
+
+//	Draws from the caller's own stream (normally the traveler's), never from
+//	the shared engine, so that workers don't race on generator state.
+Direction newDirection(RandomStream& rng, Direction forbiddenDir)
+{
+	bool noDir = true;
+
+	Direction dir = Direction::NUM_DIRECTIONS;
+	while (noDir)
+	{
+		dir = static_cast<Direction>(rng.nextBelow(static_cast<uint32_t>(Direction::NUM_DIRECTIONS)));
+		noDir = (dir==forbiddenDir);
+	}
+	return dir;
+}
+
+
+//	Adds a segment behind currentSeg, in the direction it points to, if
+//	that square is free
+TravelerSegment newTravelerSegment(const TravelerSegment& currentSeg, RandomStream& rng, bool& canAdd)
+{
+	TravelerSegment newSeg;
+	canAdd = currentSeg.dir != Direction::NUM_DIRECTIONS &&
+			 (freeSquares.freeNeighbors(currentSeg.row, currentSeg.col) & (1U << static_cast<int>(currentSeg.dir)));
+	if (canAdd)
+	{
+		newSeg.row = currentSeg.row + rowStep(currentSeg.dir);
+		newSeg.col = currentSeg.col + colStep(currentSeg.dir);
+		newSeg.dir = newDirection(rng, oppositeDirection(currentSeg.dir));
+		placeTraveler(newSeg.row, newSeg.col);
+	}
+	
+	return newSeg;
+}
+
+//	Part of the grid a maze generator works in
+struct GridRegion
+{
+	unsigned int firstRow, firstCol;
+	unsigned int numRows, numCols;
+};
+
+//	A partition generatePartitionsIn() put on the grid, still to be added
+//	to partitionList
+struct PartitionPlacement
+{
+	bool isVertical;
+	GridPosition first;
+	unsigned int length;
+};
+
+//	Walls of a region, drawn from gen.  Only reads and writes the region's
+//	own squares, so that regions can get their walls at the same time.
+template <typename Generator>
+void generateWallsIn(const GridRegion& region, Generator& gen)
+{
+	//	our own copies of the distributions, for the same reason
+	bernoulli_distribution coin = headsOrTails;
+	uniform_int_distribution<unsigned int> anyNumber = unsignedNumberGenerator;
+
+	const unsigned int NUM_WALLS = (region.numCols+region.numRows)/4;
+
+	//	I decide that a wall length  cannot be less than 3  and not more than
+	//	1/4 the grid dimension in its Direction
+	const unsigned int MIN_WALL_LENGTH = 3;
+	const unsigned int MAX_HORIZ_WALL_LENGTH = region.numCols / 3;
+	const unsigned int MAX_VERT_WALL_LENGTH = region.numRows / 3;
+	const unsigned int MAX_NUM_TRIES = 20;
+
+	bool goodWall = true;
+	
+	//	Generate the vertical walls
+	for (unsigned int w=0; w< NUM_WALLS; w++)
+	{
+		goodWall = false;
+		
+		//	Case of a vertical wall
+		if (coin(gen))
+		{
+			//	I try a few times before giving up
+			for (unsigned int k=0; k<MAX_NUM_TRIES && !goodWall; k++)
+			{
+				//	let's be hopeful
+				goodWall = true;
+				
+				//	select a column index
+				unsigned int HSP = region.numCols/(NUM_WALLS/2+1);
+				unsigned int col = region.firstCol + (1+ anyNumber(gen)%(NUM_WALLS/2-1))*HSP;
+				unsigned int length = MIN_WALL_LENGTH + anyNumber(gen)%(MAX_VERT_WALL_LENGTH-MIN_WALL_LENGTH+1);
+				
+				//	now a random start row
+				unsigned int startRow = region.firstRow + anyNumber(gen)%(region.numRows-length);
+				for (unsigned int row=startRow, i=0; i<length && goodWall; i++, row++)
+				{
+					if (grid.get(row, col) != SquareType::FREE_SQUARE)
+						goodWall = false;
+				}
+				
+				//	if the wall first, add it to the grid
+				if (goodWall)
+				{
+					for (unsigned int row=startRow, i=0; i<length && goodWall; i++, row++)
+					{
+						grid.set(row, col, SquareType::WALL);
+					}
+				}
+			}
+		}
+		// case of a horizontal wall
+		else
+		{
+			goodWall = false;
+			
+			//	I try a few times before giving up
+			for (unsigned int k=0; k<MAX_NUM_TRIES && !goodWall; k++)
+			{
+				//	let's be hopeful
+				goodWall = true;
+				
+				//	select a column index
+				unsigned int VSP = region.numRows/(NUM_WALLS/2+1);
+				unsigned int row = region.firstRow + (1+ anyNumber(gen)%(NUM_WALLS/2-1))*VSP;
+				unsigned int length = MIN_WALL_LENGTH + anyNumber(gen)%(MAX_HORIZ_WALL_LENGTH-MIN_WALL_LENGTH+1);
+				
+				//	now a random start row
+				unsigned int startCol = region.firstCol + anyNumber(gen)%(region.numCols-length);
+				for (unsigned int col=startCol, i=0; i<length && goodWall; i++, col++)
+				{
+					if (grid.get(row, col) != SquareType::FREE_SQUARE)
+						goodWall = false;
+				}
+				
+				//	if the wall first, add it to the grid
+				if (goodWall)
+				{
+					for (unsigned int col=startCol, i=0; i<length && goodWall; i++, col++)
+					{
+						grid.set(row, col, SquareType::WALL);
+					}
+				}
+			}
+		}
+	}
+}
+
+//	Up to numParts partitions in a region, drawn from gen.  They go on the
+//	grid right away, and into placedList for the caller to add to
+//	partitionList (which only one thread can do).
+template <typename Generator>
+void generatePartitionsIn(const GridRegion& region, unsigned int numParts, Generator& gen,
+						  vector<PartitionPlacement>& placedList)
+{
+	bernoulli_distribution coin = headsOrTails;
+	uniform_int_distribution<unsigned int> anyNumber = unsignedNumberGenerator;
+
+	//	The partitions go on evenly spaced lanes (rows or columns)
+	const unsigned int NUM_LANES = (region.numCols+region.numRows)/4;
+
+	//	I decide that a partition length  cannot be less than 3  and not more than
+	//	1/4 the grid dimension in its Direction
+	const unsigned int MIN_PARTITION_LENGTH = 3;
+	const unsigned int MAX_HORIZ_PART_LENGTH = region.numCols / 3;
+	const unsigned int MAX_VERT_PART_LENGTH = region.numRows / 3;
+	const unsigned int MAX_NUM_TRIES = 20;
+
+	bool goodPart = true;
+
+	for (unsigned int w=0; w< numParts; w++)
+	{
+		goodPart = false;
+		
+		//	Case of a vertical partition
+		if (coin(gen))
+		{
+			//	I try a few times before giving up
+			for (unsigned int k=0; k<MAX_NUM_TRIES && !goodPart; k++)
+			{
+				//	let's be hopeful
+				goodPart = true;
+				
+				//	select a column index
+				unsigned int HSP = region.numCols/(NUM_LANES/2+1);
+				unsigned int col = region.firstCol + (1+ anyNumber(gen)%(NUM_LANES/2-2))*HSP + HSP/2;
+				unsigned int length = MIN_PARTITION_LENGTH + anyNumber(gen)%(MAX_VERT_PART_LENGTH-MIN_PARTITION_LENGTH+1);
+				
+				//	now a random start row
+				unsigned int startRow = region.firstRow + anyNumber(gen)%(region.numRows-length);
+				for (unsigned int row=startRow, i=0; i<length && goodPart; i++, row++)
+				{
+					if (grid.get(row, col) != SquareType::FREE_SQUARE)
+						goodPart = false;
+				}
+				
+				//	if the partition is possible, add it to the grid
+				if (goodPart)
+				{
+					for (unsigned int row=startRow, i=0; i<length && goodPart; i++, row++)
+					{
+						grid.set(row, col, SquareType::VERTICAL_PARTITION);
+					}
+					placedList.push_back({true, {startRow, col}, length});
+				}
+			}
+		}
+		// case of a horizontal partition
+		else
+		{
+			goodPart = false;
+			
+			//	I try a few times before giving up
+			for (unsigned int k=0; k<MAX_NUM_TRIES && !goodPart; k++)
+			{
+				//	let's be hopeful
+				goodPart = true;
+				
+				//	select a column index
+				unsigned int VSP = region.numRows/(NUM_LANES/2+1);
+				unsigned int row = region.firstRow + (1+ anyNumber(gen)%(NUM_LANES/2-2))*VSP + VSP/2;
+				unsigned int length = MIN_PARTITION_LENGTH + anyNumber(gen)%(MAX_HORIZ_PART_LENGTH-MIN_PARTITION_LENGTH+1);
+				
+				//	now a random start row
+				unsigned int startCol = region.firstCol + anyNumber(gen)%(region.numCols-length);
+				for (unsigned int col=startCol, i=0; i<length && goodPart; i++, col++)
+				{
+					if (grid.get(row, col) != SquareType::FREE_SQUARE)
+						goodPart = false;
+				}
+				
+				//	if the wall first, add it to the grid
+				if (goodPart)
+				{
+					for (unsigned int col=startCol, i=0; i<length && goodPart; i++, col++)
+					{
+						grid.set(row, col, SquareType::HORIZONTAL_PARTITION);
+					}
+					placedList.push_back({false, {row, startCol}, length});
+				}
+			}
+		}
+	}
+}
+
+//	Builds the SlidingPartition object of a partition already on the grid
+void addPartition(const PartitionPlacement& placed)
+{
+	SlidingPartition* part = simulationArena.create<SlidingPartition>();
+	part->isVertical = placed.isVertical;
+	part->blockList = simulationArena.createArray<GridPosition>(placed.length);
+	for (unsigned int i=0; i<placed.length; i++)
+	{
+		part->blockList[i] = placed.isVertical ? GridPosition{placed.first.row + i, placed.first.col}
+											   : GridPosition{placed.first.row, placed.first.col + i};
+	}
+	part->index = static_cast<uint16_t>(partitionList.size());
+	for (auto& pos : part->blockList)
+		setPartitionId(pos.row, pos.col, part->index);
+	partitionList.push_back(part);
+}
+
+void generateWalls(void)
+{
+	generateWallsIn(GridRegion{0, 0, numRows, numCols}, engine);
+}
+
+void generatePartitions(void)
+{
+	//	How many partitions we try to place is --partitions, one per lane by
+	//	default.  Either way it stays below NO_PARTITION, so a partition's
+	//	index always fits in the square-to-partition index.
+	const unsigned int NUM_LANES = (numCols+numRows)/4;
+	const unsigned int NUM_PARTS = (numPartitions >= 0) ? numPartitions : NUM_LANES;
+
+	vector<PartitionPlacement> placedList;
+	generatePartitionsIn(GridRegion{0, 0, numRows, numCols}, NUM_PARTS, engine, placedList);
+	for (const PartitionPlacement& placed : placedList)
+		addPartition(placed);
+}
+
+//	The tiled maze:  the grid is cut into tiles of mazeTileSize to twice
+//	that on a side, and each tile gets the walls of a grid its size and its
+//	share of the partitions, and then (once freeSquares knows the squares
+//	left) the heads of its share of the travelers.  The tiles go to the
+//	workers of the pool, and each one draws from its own random stream, so
+//	the maze only depends on the seed, not on which worker did which tile.
+//	The partitions then join partitionList in tile order.
+//	headList gets each traveler's head, or a row off the grid if its tile
+//	was full.
+void generateTiledMaze(WorkerPool& pool, vector<TravelerSegment>& headList)
+{
+	const unsigned int numTileRows = max(1U, numRows / mazeTileSize);
+	const unsigned int numTileCols = max(1U, numCols / mazeTileSize);
+	const unsigned int numTiles = numTileRows * numTileCols;
+	const unsigned int NUM_PARTS = (numPartitions >= 0) ? numPartitions : (numCols+numRows)/4;
+
+	vector<GridRegion> regionList(numTiles);
+	vector<RandomStream> rngList(numTiles);
+	for (unsigned int t=0; t<numTiles; t++)
+	{
+		unsigned int tileRow = t / numTileCols, tileCol = t % numTileCols;
+		GridRegion& region = regionList[t];
+		region.firstRow = static_cast<unsigned int>(static_cast<uint64_t>(tileRow) * numRows / numTileRows);
+		region.firstCol = static_cast<unsigned int>(static_cast<uint64_t>(tileCol) * numCols / numTileCols);
+		region.numRows = static_cast<unsigned int>(static_cast<uint64_t>(tileRow + 1) * numRows / numTileRows) - region.firstRow;
+		region.numCols = static_cast<unsigned int>(static_cast<uint64_t>(tileCol + 1) * numCols / numTileCols) - region.firstCol;
+		rngList[t] = RandomStream(randomSeed + MAZE_STREAM_OFFSET, t);
+	}
+
+	//	Walls and partitions
+	vector<vector<PartitionPlacement> > placedList(numTiles);
+	atomic<unsigned int> nextTile(0);
+	pool.run([&](unsigned int) {
+		for (unsigned int t; (t = nextTile.fetch_add(1, memory_order_relaxed)) < numTiles; )
+		{
+			generateWallsIn(regionList[t], rngList[t]);
+			unsigned int numParts = static_cast<unsigned int>(static_cast<uint64_t>(t + 1) * NUM_PARTS / numTiles -
+															   static_cast<uint64_t>(t) * NUM_PARTS / numTiles);
+			generatePartitionsIn(regionList[t], numParts, rngList[t], placedList[t]);
+		}
+	});
+	freeSquares.build(grid, pool);
+
+	//	Travelers' heads, each on one of the squares its tile has left:
+	//	count them row by row, draw the rank of one, and find it.  Only the
+	//	bits of the tile's own rows get read, so the tiles don't have to
+	//	wait for each other.
+	headList.assign(numTravelers, TravelerSegment{numRows, 0, Direction::NUM_DIRECTIONS});
+	nextTile = 0;
+	pool.run([&](unsigned int) {
+		vector<uint32_t> rowFreeList;
+		for (unsigned int t; (t = nextTile.fetch_add(1, memory_order_relaxed)) < numTiles; )
+		{
+			unsigned int first = static_cast<unsigned int>(static_cast<uint64_t>(t) * numTravelers / numTiles);
+			unsigned int last = static_cast<unsigned int>(static_cast<uint64_t>(t + 1) * numTravelers / numTiles);
+			if (first == last)
+				continue;
+
+			const GridRegion& region = regionList[t];
+			RandomStream& rng = rngList[t];
+			rowFreeList.resize(region.numRows);
+			uint32_t numFree = 0;
+			for (unsigned int i=0; i<region.numRows; i++)
+			{
+				size_t rowStart = grid.index(region.firstRow + i, region.firstCol);
+				rowFreeList[i] = static_cast<uint32_t>(freeSquares.countRange(rowStart, rowStart + region.numCols));
+				numFree += rowFreeList[i];
+			}
+
+			for (unsigned int k=first; k<last && numFree > 0; k++, numFree--)
+			{
+				uint32_t rank = rng.nextBelow(numFree);
+				unsigned int i = 0;
+				for (; rank >= rowFreeList[i]; i++)
+					rank -= rowFreeList[i];
+				size_t rowStart = grid.index(region.firstRow + i, region.firstCol);
+				size_t index = freeSquares.selectInRange(rowStart, rowStart + region.numCols, rank);
+				rowFreeList[i]--;
+
+				unsigned int row = static_cast<unsigned int>(index / numCols);
+				unsigned int col = static_cast<unsigned int>(index % numCols);
+				headList[k] = {row, col, static_cast<Direction>(rng.nextBelow(static_cast<uint32_t>(Direction::NUM_DIRECTIONS)))};
+				grid.set(row, col, SquareType::TRAVELER);
+				freeSquares.clearSquare(index);
+			}
+		}
+	});
+	freeSquares.recount(pool);
+
+	for (const auto& tilePlacedList : placedList)
+		for (const PartitionPlacement& placed : tilePlacedList)
+			addPartition(placed);
+}
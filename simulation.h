@@ -0,0 +1,176 @@
+//
+//  simulation.h
+//  Final Project CSC412
+//
+//	The simulation engine:  grid, travelers, partitions, and the worker
+//	threads that move them around.  Nothing in here knows about OpenGL/glut,
+//	so that the engine can be linked into the graphic front end (main.cpp)
+//	or into the headless driver (headless.cpp).
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dataTypes.h"
+#include "grid.h"
+#include "latencyHistogram.h"
+#include "lockManager.h"
+#include "travelerStore.h"
+
+//-----------------------------------------------------------------------------
+//	Simulation state (defined in simulation.cpp)
+//-----------------------------------------------------------------------------
+
+extern Grid grid;
+extern unsigned int numRows;			//	height of the grid
+extern unsigned int numCols;			//	width
+extern unsigned int numTravelers;		//	initial number = numTravelersDone + numLiveThreads
+extern unsigned int numTravelersDone;
+extern unsigned int numLiveThreads;		//	the number of live worker threads
+extern GridPosition exitPos;			//	location of the exit (randomly generated)
+extern std::mutex globalMutex;
+extern LockManager gridLocks;
+extern LockGranularity lockGranularity;	//	how gridLocks gets configured
+extern unsigned int lockTileSize;		//	side of a lock tile (TILE granularity)
+extern unsigned int numLockStripes;		//	number of locks (STRIPE granularity)
+extern TravelerStore travelers;
+extern std::vector<SlidingPartition*> partitionList;
+
+//	travelers' sleep time between moves (in microseconds)
+extern const int MIN_SLEEP_TIME;
+extern int travelerSleepTime;
+
+//	seed of all the random generators of the simulation
+extern unsigned long randomSeed;
+
+//	size of the worker pool (0 means one worker per hardware core)
+extern unsigned int numWorkers;
+
+//	how the workers synchronize their moves, and all the modes requested on
+//	the command line (the headless driver runs each of them in turn)
+extern EngineMode engineMode;
+extern std::vector<EngineMode> engineModeList;
+
+//	number of successful head moves and partition slides since the start of
+//	the simulation, and number of ticks (every traveler moved once) completed
+extern std::atomic<unsigned long> numMovesDone;
+extern std::atomic<unsigned long> numSlidesDone;
+extern std::atomic<unsigned long> numTicksDone;
+
+//	runSimulation() stops after that many ticks (0 means no limit)
+extern unsigned long maxNumTicks;
+
+//	number of partitions initializeApplication() tries to place (-1 means
+//	the default, about (numRows+numCols)/4)
+extern int numPartitions;
+
+//	how initializeApplication() places the walls, partitions, and travelers
+extern MazeMode mazeMode;
+extern unsigned int mazeTileSize;		//	smallest side of a tile (TILED mode)
+
+//	how the travelers pick their direction, and in gradient mode the fraction
+//	of their moves that stay random (in [0, 1])
+extern RoutingMode routingMode;
+extern double explorationRate;
+
+//	number of segments the travelers start with, number of moves after
+//	which a traveler grows one more (0:  never), and most segments a
+//	traveler can have (0:  as many as it starts with, or a default limit
+//	if it grows).  Distributed runs only support single-segment travelers.
+extern unsigned int numInitialSegments;
+extern unsigned int movesPerGrowth;
+extern unsigned int maxNumSegments;
+
+//	When measureStepLatency is set, runSimulation() times every traveler
+//	step into stepLatency.
+extern bool measureStepLatency;
+extern LatencyHistogram stepLatency;
+
+//	Counters of the hot path, summed over all the workers since the last
+//	initializeApplication().  Wait times are in nanoseconds, and only count
+//	the waits for a lock somebody else held.
+struct SimulationStats
+{
+	unsigned long outcomeCount[static_cast<int>(MoveOutcome::NUM_MOVE_OUTCOMES)];
+	//	sum of outcomeCount
+	unsigned long numMoveAttempts;
+	unsigned long numSlideAttempts;
+	unsigned long numSlideSuccesses;
+	unsigned long gridLockWaitTime;
+	unsigned long travelerLockWaitTime;
+};
+
+//	When publishFrames is set (before initializeApplication()), the engines
+//	publish a FrameSnapshot at the end of a tick, whenever the renderer has
+//	taken the previous one.  The headless drivers leave it off.
+extern bool publishFrames;
+
+//	number of processes of a distributed run, and how they talk to each other
+extern unsigned int numProcesses;
+extern TransportMode transportMode;
+
+//-----------------------------------------------------------------------------
+//	Function prototypes
+//-----------------------------------------------------------------------------
+
+//	Sets numRows, numCols, numTravelers, numWorkers, engineMode(List), the lock
+//	granularity, randomSeed, travelerSleepTime, and maxNumTicks
+//	from the command line.  Prints a usage message and exits on bad input.
+//	Sizes and counts that the driver set beforehand act as defaults.
+void parseArguments(int argc, char* argv[]);
+
+//	Allocates the grid, generates walls, partitions, and travelers.
+//	numRows, numCols, and numTravelers must have been set before this gets called.
+void initializeApplication(void);
+
+//	Moves the travelers on a pool of numWorkers threads until they have all
+//	left through the exit, maxNumTicks is reached, or stopSimulation() gets called.  Blocks until then.
+void runSimulation(void);
+
+//	Asks runSimulation() to return at the end of the current tick
+void stopSimulation(void);
+
+//	Sums up the workers' counters.  Takes no lock, so it can be called at
+//	any time, e.g. by the display while the simulation runs;  the counts
+//	are then a few steps behind.
+SimulationStats getSimulationStats(void);
+
+//	Latest frame the engines published (empty until the first one).  Takes
+//	no lock.  Only one thread (the renderer) may call this;  the frame stays
+//	valid until its next call.
+const FrameSnapshot& acquireFrame(void);
+
+//	Runs this process's share of a distributed simulation:  the band of rows
+//	numbered transport.rank(), out of transport.numRanks().  All the ranks
+//	must start from the same world (same arguments and seed).  Returns when
+//	all the travelers are gone or maxNumTicks is reached;  rank 0 then holds
+//	the final state of the whole world, and the totals of all the counters.
+class Transport;
+void runDistributedRank(Transport& transport);
+
+//	Largest message a rank of a distributed run sends another in one exchange
+size_t maxRankMessageSize(void);
+
+//	Checks that the grid agrees with the travelers and partitions:  every
+//	segment and block is on a square of the right type, and there are no
+//	other traveler or partition squares.  Only call this between ticks.
+//	@param problem receives a description of the first inconsistency found
+//	@return true if the grid is consistent
+bool checkGridConsistency(std::string& problem);
+
+//	Checks that the distance field, as the partitions' slides left it, is
+//	the one a search from scratch finds on the grid as it is now (true if
+//	there is no field).  Only call this between ticks, and not on a rank
+//	of a distributed run (which only repairs the field for its own band).
+//	@param problem receives the first square whose distance is wrong
+bool checkDistanceField(std::string& problem);
+
+//	Frees everything allocated by initializeApplication.  Only call this
+//	once runSimulation() has returned.
+void cleanupSimulation(void);
+
+#endif //	SIMULATION_H
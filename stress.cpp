@@ -0,0 +1,176 @@
+//
+//  stress.cpp
+//  Final Project CSC412
+//
+//	Stress test for the synchronization of moves and partition slides.
+//	Runs a small, crowded grid (so that travelers keep pushing partitions
+//	into each other) on many more workers than cores, for every engine and
+//	every lock granularity, with random and with gradient routing (so that
+//	the distance field gets repaired after slides that raced each other).
+//	A watchdog thread declares a stall if no tick completes for
+//	STALL_TIMEOUT seconds, and the grid (and the distance field) is checked
+//	for consistency after each run.  Then the same engines run on tiled
+//	mazes, on a grid crowded enough that some tiles run out of room.  Exit
+//	status is 0 only if every run passed.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+//
+#include "simulation.h"
+#include <unistd.h>
+
+using namespace std;
+
+//	Scenario defaults (all can be overridden on the command line)
+const unsigned int STRESS_NUM_ROWS = 40;
+const unsigned int STRESS_NUM_COLS = 40;
+const unsigned int STRESS_NUM_TRAVELERS = 500;
+const unsigned int STRESS_NUM_WORKERS = 64;
+const unsigned long STRESS_NUM_TICKS = 300;
+//	smallest side of the tiles of the tiled maze runs (the default grid is
+//	then 3 x 3 tiles of 13 or 14 squares a side)
+const unsigned int STRESS_MAZE_TILE_SIZE = 12;
+
+//	A run that completes no tick for that long is considered stalled
+const int STALL_TIMEOUT = 10;
+//	how often (in microseconds) the watchdog looks at the tick counter
+const int WATCHDOG_SLEEP_TIME = 100000;
+
+//	Runs the simulation once with the current settings.
+//	Returns false (after printing why) on a stall or an inconsistent grid.
+bool stressRun(const string& label)
+{
+	initializeApplication();
+
+	atomic<bool> runDone(false);
+	thread watchdog([&]{
+		unsigned long lastTick = numTicksDone.load();
+		chrono::steady_clock::time_point lastProgress = chrono::steady_clock::now();
+		while (!runDone.load())
+		{
+			usleep(WATCHDOG_SLEEP_TIME);
+			unsigned long tick = numTicksDone.load();
+			chrono::steady_clock::time_point now = chrono::steady_clock::now();
+			if (tick != lastTick)
+			{
+				lastTick = tick;
+				lastProgress = now;
+			}
+			else if (chrono::duration<double>(now - lastProgress).count() > STALL_TIMEOUT)
+			{
+				//	the workers are stuck, so there is no clean way out
+				printf("%-28s STALLED at tick %lu (no progress for %d s)\n",
+					   label.c_str(), tick, STALL_TIMEOUT);
+				fflush(stdout);
+				_exit(2);
+			}
+		}
+	});
+
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	runSimulation();
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	runDone = true;
+	watchdog.join();
+
+	string problem;
+	bool ok = checkGridConsistency(problem) && checkDistanceField(problem);
+	printf("%-28s %8lu %10lu %10lu %10.3f  %s\n",
+		   label.c_str(), numTicksDone.load(), numMovesDone.load(), numSlidesDone.load(), elapsed,
+		   ok ? "ok" : ("INCONSISTENT: " + problem).c_str());
+
+	cleanupSimulation();
+	return ok;
+}
+
+//	Number of squares the maze leaves to the travelers with the current
+//	settings.  The maze only depends on the seed and the grid, so a run
+//	with any number of travelers gets the same one.
+unsigned int countMazeFreeSquares(void)
+{
+	const unsigned int savedNumTravelers = numTravelers;
+	numTravelers = 1;
+	initializeApplication();
+	unsigned int numFree = 0;
+	for (unsigned int i=0; i<numRows; i++)
+		for (unsigned int j=0; j<numCols; j++)
+			numFree += (grid.get(i, j) == SquareType::FREE_SQUARE || grid.get(i, j) == SquareType::TRAVELER);
+	cleanupSimulation();
+	numTravelers = savedNumTravelers;
+	return numFree;
+}
+
+int main(int argc, char* argv[])
+{
+	numRows = STRESS_NUM_ROWS;
+	numCols = STRESS_NUM_COLS;
+	numTravelers = STRESS_NUM_TRAVELERS;
+	numWorkers = STRESS_NUM_WORKERS;
+	maxNumTicks = STRESS_NUM_TICKS;
+	engineModeList = {EngineMode::MUTEX, EngineMode::CAS, EngineMode::TICK,
+					  EngineMode::REGION};
+	travelerSleepTime = 0;
+	parseArguments(argc, argv);
+
+	printf("grid %u x %u, %u travelers, %lu ticks, seed %lu\n\n",
+		   numRows, numCols, numTravelers, maxNumTicks, randomSeed);
+	printf("%-28s %8s %10s %10s %10s\n", "run", "ticks", "moves", "slides", "time (s)");
+
+	bool allOk = true;
+	const unsigned int baseNumWorkers = numWorkers;
+	for (unsigned int workers : {baseNumWorkers, 2*baseNumWorkers})
+	{
+		numWorkers = workers;
+		for (RoutingMode routing : {RoutingMode::RANDOM, RoutingMode::GRADIENT})
+		{
+			routingMode = routing;
+			string suffix = (routing == RoutingMode::RANDOM ? "" : "/" + routingStr(routing)) +
+							" x" + to_string(workers);
+			for (EngineMode mode : engineModeList)
+			{
+				engineMode = mode;
+				if (mode == EngineMode::MUTEX)
+				{
+					for (int k=0; k<static_cast<int>(LockGranularity::NUM_LOCK_GRANULARITIES); k++)
+					{
+						lockGranularity = static_cast<LockGranularity>(k);
+						allOk &= stressRun(engineStr(mode) + "/" + lockStr(lockGranularity) + suffix);
+					}
+				}
+				else
+				{
+					allOk &= stressRun(engineStr(mode) + suffix);
+				}
+			}
+		}
+	}
+
+	//	Tiled mazes, each tile generated and filled by whichever worker
+	//	takes it:  with the usual crowd, then with one traveler short of a
+	//	full grid, so that the tiles with the least room run out of it and
+	//	their last travelers go wherever the whole grid has room left
+	numWorkers = baseNumWorkers;
+	routingMode = RoutingMode::RANDOM;
+	lockGranularity = LockGranularity::CELL;
+	mazeMode = MazeMode::TILED;
+	mazeTileSize = STRESS_MAZE_TILE_SIZE;
+	const unsigned int baseNumTravelers = numTravelers;
+	for (bool isFull : {false, true})
+	{
+		numTravelers = isFull ? countMazeFreeSquares() - 1 : baseNumTravelers;
+		for (EngineMode mode : engineModeList)
+		{
+			engineMode = mode;
+			allOk &= stressRun(engineStr(mode) + (isFull ? "/tiled-full" : "/tiled") +
+							   " x" + to_string(baseNumWorkers));
+		}
+	}
+
+	printf("\n%s\n", allOk ? "PASSED" : "FAILED");
+	return allOk ? 0 : 1;
+}
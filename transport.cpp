@@ -0,0 +1,313 @@
+//
+//  transport.cpp
+//  Final Project CSC412
+//
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+//
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "transport.h"
+
+using namespace std;
+
+//	A transport that breaks leaves the ranks out of step, and there is no
+//	way to recover from that:  report and quit.
+static void transportFailure(const char* what)
+{
+	fprintf(stderr, "transport: %s: %s\n", what, strerror(errno));
+	exit(1);
+}
+
+void clearMessages(MessageList& messages, unsigned int numRanks)
+{
+	messages.resize(numRanks);
+	for (auto& message : messages)
+		message.clear();
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark SharedMemoryTransport
+//-----------------------------------------------------------------------------
+#endif
+
+//	every mailbox starts on its own cache line
+const size_t MAILBOX_ALIGNMENT = 64;
+
+SharedMemoryTransport::SharedMemoryTransport(unsigned int numRanks, size_t maxMessageSize)
+	:	capacity(maxMessageSize),
+		currentSet(0)
+{
+	rankCount = numRanks;
+	mailboxSize = (sizeof(uint64_t) + capacity + MAILBOX_ALIGNMENT - 1) / MAILBOX_ALIGNMENT * MAILBOX_ALIGNMENT;
+	mappedSize = MAILBOX_ALIGNMENT + 2 * static_cast<size_t>(numRanks) * numRanks * mailboxSize;
+
+	mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (mapped == MAP_FAILED)
+		transportFailure("mmap");
+
+	barrier = static_cast<pthread_barrier_t*>(mapped);
+	pthread_barrierattr_t attr;
+	pthread_barrierattr_init(&attr);
+	pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	pthread_barrier_init(barrier, &attr, numRanks);
+	pthread_barrierattr_destroy(&attr);
+}
+
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+	//	every process that inherited the mapping unmaps its own copy;  the
+	//	barrier itself lives on until the last one is gone
+	munmap(mapped, mappedSize);
+}
+
+char* SharedMemoryTransport::mailbox(unsigned int set, unsigned int sender, unsigned int receiver)
+{
+	size_t slot = (static_cast<size_t>(set) * rankCount + sender) * rankCount + receiver;
+	return static_cast<char*>(mapped) + MAILBOX_ALIGNMENT + slot * mailboxSize;
+}
+
+void SharedMemoryTransport::exchange(const MessageList& outgoing, MessageList& incoming)
+{
+	for (unsigned int r=0; r<rankCount; r++)
+	{
+		if (r == myRank)
+			continue;
+
+		uint64_t length = outgoing[r].size();
+		if (length > capacity)
+		{
+			fprintf(stderr, "transport: %lu-byte message for rank %u, mailboxes hold %zu\n",
+					static_cast<unsigned long>(length), r, capacity);
+			exit(1);
+		}
+		char* box = mailbox(currentSet, myRank, r);
+		memcpy(box, &length, sizeof(length));
+		memcpy(box + sizeof(length), outgoing[r].data(), length);
+	}
+
+	pthread_barrier_wait(barrier);
+
+	clearMessages(incoming, rankCount);
+	for (unsigned int r=0; r<rankCount; r++)
+	{
+		if (r == myRank)
+			continue;
+
+		const char* box = mailbox(currentSet, r, myRank);
+		uint64_t length;
+		memcpy(&length, box, sizeof(length));
+		incoming[r].assign(box + sizeof(length), box + sizeof(length) + length);
+	}
+
+	currentSet ^= 1;
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark TcpTransport
+//-----------------------------------------------------------------------------
+#endif
+
+TcpTransport::TcpTransport(unsigned int rank, const vector<sockaddr_in>& addressList, int listenSocket)
+	:	peerSocket(addressList.size(), -1)
+{
+	myRank = rank;
+	rankCount = static_cast<unsigned int>(addressList.size());
+
+	//	connect to the ranks before this one, and tell them who we are
+	for (unsigned int r=0; r<myRank; r++)
+	{
+		int sock = socket(AF_INET, SOCK_STREAM, 0);
+		if (sock < 0)
+			transportFailure("socket");
+		if (connect(sock, reinterpret_cast<const sockaddr*>(&addressList[r]), sizeof(sockaddr_in)) < 0)
+			transportFailure("connect");
+
+		uint32_t id = myRank;
+		if (send(sock, &id, sizeof(id), 0) != sizeof(id))
+			transportFailure("send");
+		peerSocket[r] = sock;
+	}
+
+	//	then accept the ones after it, in whatever order they show up
+	for (unsigned int k=myRank+1; k<rankCount; k++)
+	{
+		int sock = accept(listenSocket, nullptr, nullptr);
+		if (sock < 0)
+			transportFailure("accept");
+
+		uint32_t id;
+		if (recv(sock, &id, sizeof(id), MSG_WAITALL) != sizeof(id) || id <= myRank || id >= rankCount)
+			transportFailure("handshake");
+		peerSocket[id] = sock;
+	}
+	close(listenSocket);
+
+	//	the messages are small and every exchange waits for them
+	for (int sock : peerSocket)
+	{
+		int on = 1;
+		if (sock >= 0)
+			setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	}
+}
+
+TcpTransport::~TcpTransport()
+{
+	for (int sock : peerSocket)
+	{
+		if (sock >= 0)
+			close(sock);
+	}
+}
+
+int TcpTransport::listenOnLoopback(sockaddr_in& address)
+{
+	int sock = socket(AF_INET, SOCK_STREAM, 0);
+	if (sock < 0)
+		transportFailure("socket");
+
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+
+	socklen_t length = sizeof(address);
+	if (bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+		listen(sock, SOMAXCONN) < 0 ||
+		getsockname(sock, reinterpret_cast<sockaddr*>(&address), &length) < 0)
+		transportFailure("listen");
+
+	return sock;
+}
+
+void TcpTransport::exchange(const MessageList& outgoing, MessageList& incoming)
+{
+	//	Every message goes out with an 8-byte length prefix.  All the sends
+	//	and receives progress together, so that two ranks sending each other
+	//	more than a socket buffer's worth can't block each other.
+	struct PeerProgress
+	{
+		uint64_t outLength;
+		size_t numSent;
+		uint64_t inLength;
+		size_t numReceived;
+	};
+
+	const size_t PREFIX = sizeof(uint64_t);
+	vector<PeerProgress> progress(rankCount);
+	clearMessages(incoming, rankCount);
+	unsigned int numPending = 0;
+
+	for (unsigned int r=0; r<rankCount; r++)
+	{
+		if (r == myRank)
+			continue;
+		progress[r] = {outgoing[r].size(), 0, 0, 0};
+		numPending += 2;
+	}
+
+	vector<pollfd> pollList;
+	vector<unsigned int> pollRank;
+	while (numPending > 0)
+	{
+		pollList.clear();
+		pollRank.clear();
+		for (unsigned int r=0; r<rankCount; r++)
+		{
+			if (r == myRank)
+				continue;
+			PeerProgress& p = progress[r];
+			short events = 0;
+			if (p.numSent < PREFIX + p.outLength)
+				events |= POLLOUT;
+			if (p.numReceived < PREFIX || p.numReceived < PREFIX + p.inLength)
+				events |= POLLIN;
+			if (events != 0)
+			{
+				pollList.push_back({peerSocket[r], events, 0});
+				pollRank.push_back(r);
+			}
+		}
+
+		if (poll(pollList.data(), pollList.size(), -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			transportFailure("poll");
+		}
+
+		for (size_t k=0; k<pollList.size(); k++)
+		{
+			unsigned int r = pollRank[k];
+			PeerProgress& p = progress[r];
+			int sock = pollList[k].fd;
+
+			if (pollList[k].revents & (POLLERR | POLLHUP | POLLNVAL))
+			{
+				if (!(pollList[k].revents & POLLIN))
+				{
+					errno = ECONNRESET;
+					transportFailure("peer");
+				}
+			}
+
+			if (pollList[k].revents & POLLOUT)
+			{
+				ssize_t n;
+				if (p.numSent < PREFIX)
+					n = send(sock, reinterpret_cast<const char*>(&p.outLength) + p.numSent,
+							 PREFIX - p.numSent, MSG_DONTWAIT | MSG_NOSIGNAL);
+				else
+					n = send(sock, outgoing[r].data() + (p.numSent - PREFIX),
+							 p.outLength - (p.numSent - PREFIX), MSG_DONTWAIT | MSG_NOSIGNAL);
+				if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+					transportFailure("send");
+				if (n > 0)
+				{
+					p.numSent += n;
+					if (p.numSent == PREFIX + p.outLength)
+						numPending--;
+				}
+			}
+
+			if (pollList[k].revents & POLLIN)
+			{
+				ssize_t n;
+				if (p.numReceived < PREFIX)
+					n = recv(sock, reinterpret_cast<char*>(&p.inLength) + p.numReceived,
+							 PREFIX - p.numReceived, MSG_DONTWAIT);
+				else
+					n = recv(sock, incoming[r].data() + (p.numReceived - PREFIX),
+							 p.inLength - (p.numReceived - PREFIX), MSG_DONTWAIT);
+				if (n == 0)
+				{
+					errno = ECONNRESET;
+					transportFailure("peer");
+				}
+				if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+					transportFailure("recv");
+				if (n > 0)
+				{
+					p.numReceived += n;
+					if (p.numReceived == PREFIX)
+						incoming[r].resize(p.inLength);
+					if (p.numReceived == PREFIX + p.inLength)
+						numPending--;
+				}
+			}
+		}
+	}
+}
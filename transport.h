@@ -0,0 +1,119 @@
+//
+//  transport.h
+//  Final Project CSC412
+//
+//	Message passing between the processes (ranks) of a distributed run.
+//	The only operation is a collective all-to-all exchange:  every rank
+//	hands in one message (possibly empty) for every other rank, and gets
+//	back the message every other rank had for it.  The exchange also acts
+//	as a barrier, which is all the distributed engine needs to run in
+//	lockstep ticks.
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <cstddef>
+#include <vector>
+#include <netinet/in.h>
+#include <pthread.h>
+#include "dataTypes.h"
+
+//	One message per rank
+typedef std::vector<std::vector<char> > MessageList;
+
+//	Makes messages numRanks empty messages, keeping the capacity of the
+//	ones it had, so that a run's exchanges stop allocating once the
+//	messages have reached their usual size
+void clearMessages(MessageList& messages, unsigned int numRanks);
+
+class Transport
+{
+	public:
+
+		virtual ~Transport() = default;
+
+		unsigned int rank() const { return myRank; }
+		unsigned int numRanks() const { return rankCount; }
+
+		/**	Collective operation:  all the ranks must call it the same number of times
+		 *	@param outgoing outgoing[r] is sent to rank r (outgoing[rank()] is ignored)
+		 *	@param incoming receives, in incoming[r], what rank r sent to this rank
+		 */
+		virtual void exchange(const MessageList& outgoing, MessageList& incoming) = 0;
+
+	protected:
+
+		unsigned int myRank = 0;
+		unsigned int rankCount = 1;
+};
+
+/**	Exchange through a block of shared memory with one mailbox per
+ *	(sender, receiver) pair, and a process-shared barrier.  Must be created
+ *	by the parent process before it forks the ranks;  each child then calls
+ *	setRank() before the first exchange.
+ */
+class SharedMemoryTransport : public Transport
+{
+	public:
+
+		/**	@param maxMessageSize largest message one rank sends another in one exchange
+		 */
+		SharedMemoryTransport(unsigned int numRanks, size_t maxMessageSize);
+		~SharedMemoryTransport() override;
+
+		SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+		SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+		void setRank(unsigned int rank) { myRank = rank; }
+
+		void exchange(const MessageList& outgoing, MessageList& incoming) override;
+
+	private:
+
+		//	Start of the mailbox from sender to receiver in the given set.
+		//	There are two sets, used on alternate exchanges, so that a rank
+		//	can write its next messages while a slower one still reads the
+		//	previous ones, and a single barrier per exchange is enough.
+		char* mailbox(unsigned int set, unsigned int sender, unsigned int receiver);
+
+		size_t capacity;
+		size_t mailboxSize;
+		size_t mappedSize;
+		void* mapped;
+		pthread_barrier_t* barrier;
+		unsigned int currentSet;
+};
+
+/**	Exchange over TCP connections, one per pair of ranks.  The ranks can be
+ *	on different hosts:  each one listens on its own address, connects to
+ *	the ranks before it in the list, and accepts the connections of the
+ *	ranks after it.
+ */
+class TcpTransport : public Transport
+{
+	public:
+
+		/**	@param addressList listening address of every rank
+		 *	@param listenSocket this rank's socket, already bound to addressList[rank] and listening
+		 */
+		TcpTransport(unsigned int rank, const std::vector<sockaddr_in>& addressList, int listenSocket);
+		~TcpTransport() override;
+
+		TcpTransport(const TcpTransport&) = delete;
+		TcpTransport& operator=(const TcpTransport&) = delete;
+
+		void exchange(const MessageList& outgoing, MessageList& incoming) override;
+
+		/**	Creates a socket listening on 127.0.0.1, on a port picked by the system
+		 *	@param address receives the address the socket is bound to
+		 *	@return the socket
+		 */
+		static int listenOnLoopback(sockaddr_in& address);
+
+	private:
+
+		//	socket connected to each rank (-1 for this one)
+		std::vector<int> peerSocket;
+};
+
+#endif //	TRANSPORT_H
@@ -0,0 +1,183 @@
+//
+//  travelerStore.h
+//  Final Project CSC412
+//
+//	All the travelers, stored as a structure of arrays indexed by traveler
+//	id:  the heads (position and direction), the segment counts, the states,
+//	and the random streams each sit in their own contiguous array, so that
+//	stepping a run of consecutive travelers streams through memory instead
+//	of chasing a pointer per traveler.  The rest of each traveler's body is
+//	in one flat array too, with a fixed number of slots per traveler used as
+//	a ring:  when the head advances, the old head goes in front of the body
+//	and the tail drops off the back, both in constant time and without any
+//	allocation, however long the traveler.  What the steps don't need
+//	(colors, mutexes) is kept apart.
+
+#ifndef TRAVELER_STORE_H
+#define TRAVELER_STORE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "dataTypes.h"
+#include "randomStream.h"
+
+class TravelerStore
+{
+	public:
+
+		/**	Empties the store and makes room for that many travelers
+		 *	@param maxNumSegments the most segments a traveler can have (head included)
+		 */
+		void allocate(unsigned int numTravelers, unsigned int maxNumSegments)
+		{
+			release();
+			segmentCapacity = maxNumSegments;
+			headList.reserve(numTravelers);
+			segmentCountList.reserve(numTravelers);
+			bodyStartList.reserve(numTravelers);
+			moveCountList.reserve(numTravelers);
+			stateList.reserve(numTravelers);
+			rngList.reserve(numTravelers);
+			colorList.reserve(numTravelers);
+			bodyList.resize(static_cast<size_t>(numTravelers) * (maxNumSegments - 1));
+			mutexList.reset(new std::mutex[numTravelers]);
+		}
+
+		/**	Frees the storage
+		 */
+		void release()
+		{
+			headList.clear();
+			segmentCountList.clear();
+			bodyStartList.clear();
+			moveCountList.clear();
+			stateList.clear();
+			rngList.clear();
+			colorList.clear();
+			bodyList.clear();
+			mutexList.reset();
+		}
+
+		/**	Adds a traveler (its id is the previous size()), made of its head only
+		 */
+		void add(const TravelerSegment& head, const RandomStream& rng, const float* rgba)
+		{
+			headList.push_back(head);
+			segmentCountList.push_back(1);
+			bodyStartList.push_back(0);
+			moveCountList.push_back(0);
+			stateList.push_back(TravelerState::ACTIVE);
+			rngList.push_back(rng);
+			colorList.push_back({rgba[0], rgba[1], rgba[2], rgba[3]});
+		}
+
+		unsigned int size() const { return static_cast<unsigned int>(headList.size()); }
+		unsigned int maxSegments() const { return segmentCapacity; }
+
+		TravelerSegment& head(unsigned int id) { return headList[id]; }
+		const TravelerSegment& head(unsigned int id) const { return headList[id]; }
+
+		unsigned int numSegments(unsigned int id) const { return segmentCountList[id]; }
+
+		/**	@param k 0 for the head, numSegments(id)-1 for the tail
+		 */
+		TravelerSegment& segment(unsigned int id, unsigned int k)
+		{
+			return (k == 0) ? headList[id] : bodyList[bodyIndex(id, k)];
+		}
+		const TravelerSegment& segment(unsigned int id, unsigned int k) const
+		{
+			return (k == 0) ? headList[id] : bodyList[bodyIndex(id, k)];
+		}
+
+		TravelerSegment tail(unsigned int id) const { return segment(id, segmentCountList[id] - 1); }
+
+		/**	Adds a segment behind the tail (there must be room for it)
+		 */
+		void pushTail(unsigned int id, const TravelerSegment& seg)
+		{
+			bodyList[bodyIndex(id, segmentCountList[id])] = seg;
+			segmentCountList[id]++;
+		}
+
+		/**	Removes the tail (not the head)
+		 *	@return the segment removed
+		 */
+		TravelerSegment popTail(unsigned int id)
+		{
+			segmentCountList[id]--;
+			return bodyList[bodyIndex(id, segmentCountList[id])];
+		}
+
+		/**	Moves the head to newHead:  the old head becomes segment 1, and
+		 *	the tail drops off unless the traveler grows (it only grows if
+		 *	there is room left).  Read tail() first to know what square it left.
+		 *	@return true if the traveler grew
+		 */
+		bool advanceHead(unsigned int id, const TravelerSegment& newHead, bool grow)
+		{
+			moveCountList[id]++;
+			unsigned int count = segmentCountList[id];
+			bool grows = grow && count < segmentCapacity;
+			if (grows)
+				segmentCountList[id] = ++count;
+			if (count > 1)
+			{
+				//	the body's front moves back one slot, over the old tail
+				//	if the ring is full
+				uint32_t& start = bodyStartList[id];
+				start = (start == 0) ? segmentCapacity - 2 : start - 1;
+				bodyList[bodyIndex(id, 1)] = headList[id];
+			}
+			headList[id] = newHead;
+			return grows;
+		}
+
+		/**	@return the number of times advanceHead() was called for that traveler
+		 */
+		unsigned int numMoves(unsigned int id) const { return moveCountList[id]; }
+
+		TravelerState state(unsigned int id) const { return stateList[id]; }
+		void setState(unsigned int id, TravelerState newState) { stateList[id] = newState; }
+		bool isExiting(unsigned int id) const { return stateList[id] == TravelerState::EXITING; }
+		bool isDone(unsigned int id) const { return stateList[id] == TravelerState::DONE; }
+
+		RandomStream& rng(unsigned int id) { return rngList[id]; }
+
+		const float* rgba(unsigned int id) const { return colorList[id].data(); }
+
+		/**	Per-traveler lock (mutex engine only)
+		 */
+		std::mutex& lock(unsigned int id) { return mutexList[id]; }
+
+	private:
+
+		//	slot of segment k > 0 of a traveler, in bodyList
+		size_t bodyIndex(unsigned int id, unsigned int k) const
+		{
+			unsigned int slot = bodyStartList[id] + k - 1;
+			if (slot >= segmentCapacity - 1)
+				slot -= segmentCapacity - 1;
+			return static_cast<size_t>(id) * (segmentCapacity - 1) + slot;
+		}
+
+		unsigned int segmentCapacity = 1;
+		//	hot:  what every step reads or writes
+		std::vector<TravelerSegment> headList;
+		std::vector<uint32_t> segmentCountList;
+		std::vector<uint32_t> bodyStartList;
+		std::vector<uint32_t> moveCountList;
+		std::vector<TravelerState> stateList;
+		std::vector<RandomStream> rngList;
+		//	segments 1 .. numSegments()-1 of each traveler, in a ring of
+		//	maxSegments()-1 slots that starts at its bodyStartList slot
+		std::vector<TravelerSegment> bodyList;
+		//	cold
+		std::vector<std::array<float, 4> > colorList;
+		std::unique_ptr<std::mutex[]> mutexList;
+};
+
+#endif //	TRAVELER_STORE_H
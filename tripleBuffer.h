@@ -0,0 +1,66 @@
+//
+//  tripleBuffer.h
+//  Final Project CSC412
+//
+//	Hands whole values (frames) from one producer thread to one consumer
+//	thread without either of them ever waiting for the other.  There are
+//	three buffers:  the producer fills its own, the consumer reads its own,
+//	and the third one is the latest complete value, in the middle.
+//	Publishing swaps the producer's buffer with the middle one;  taking the
+//	latest value swaps the consumer's buffer with it.  Each swap is a single
+//	atomic exchange, so neither side takes a lock, and the consumer always
+//	gets a complete value (never one the producer is still writing).
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer
+{
+	public:
+
+		/**	Buffer the producer can fill (it keeps whatever it held the last
+		 *	time this buffer went around, so vectors keep their capacity)
+		 */
+		T& writeBuffer() { return buffer[writeIndex]; }
+
+		/**	Makes the write buffer the latest value (producer only)
+		 */
+		void publish()
+		{
+			writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+		}
+
+		/**	@return true if the consumer hasn't taken the latest value yet.  The
+		 *	producer can skip filling a new one until then.
+		 */
+		bool isPending() const
+		{
+			return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+		}
+
+		/**	Takes the latest value, if there is a new one (consumer only)
+		 *	@return the latest published value, valid until the next call
+		 */
+		const T& acquire()
+		{
+			if (isPending())
+				readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+			return buffer[readIndex];
+		}
+
+	private:
+
+		static const unsigned int INDEX_MASK = 0x3;
+		static const unsigned int FRESH = 0x4;
+
+		T buffer[3];
+		unsigned int writeIndex = 0;
+		unsigned int readIndex = 1;
+		//	index of the middle buffer, plus FRESH if nobody took it yet
+		std::atomic<unsigned int> middle{2};
+};
+
+#endif //	TRIPLE_BUFFER_H
@@ -76,3 +76,232 @@ string typeStr(const SquareType& type)
 	return outStr;
 }
 
+string engineStr(const EngineMode& mode)
+{
+	string outStr;
+	switch (mode)
+	{
+		case EngineMode::MUTEX:
+			outStr = "mutex";
+			break;
+		
+		case EngineMode::CAS:
+			outStr = "cas";
+			break;
+		
+		case EngineMode::TICK:
+			outStr = "tick";
+			break;
+		
+		case EngineMode::REGION:
+			outStr = "region";
+			break;
+		
+		default:
+			outStr = "";
+			break;
+	}
+
+	return outStr;
+}
+
+string lockStr(const LockGranularity& granularity)
+{
+	string outStr;
+	switch (granularity)
+	{
+		case LockGranularity::CELL:
+			outStr = "cell";
+			break;
+		
+		case LockGranularity::TILE:
+			outStr = "tile";
+			break;
+		
+		case LockGranularity::STRIPE:
+			outStr = "stripe";
+			break;
+		
+		case LockGranularity::GLOBAL:
+			outStr = "global";
+			break;
+		
+		default:
+			outStr = "";
+			break;
+	}
+
+	return outStr;
+}
+
+string transportStr(const TransportMode& mode)
+{
+	string outStr;
+	switch (mode)
+	{
+		case TransportMode::SHARED_MEMORY:
+			outStr = "shm";
+			break;
+		
+		case TransportMode::TCP:
+			outStr = "tcp";
+			break;
+		
+		default:
+			outStr = "";
+			break;
+	}
+
+	return outStr;
+}
+
+string routingStr(const RoutingMode& mode)
+{
+	string outStr;
+	switch (mode)
+	{
+		case RoutingMode::RANDOM:
+			outStr = "random";
+			break;
+		
+		case RoutingMode::GRADIENT:
+			outStr = "gradient";
+			break;
+		
+		default:
+			outStr = "";
+			break;
+	}
+
+	return outStr;
+}
+
+string mazeStr(const MazeMode& mode)
+{
+	string outStr;
+	switch (mode)
+	{
+		case MazeMode::CLASSIC:
+			outStr = "classic";
+			break;
+		
+		case MazeMode::TILED:
+			outStr = "tiled";
+			break;
+		
+		default:
+			outStr = "";
+			break;
+	}
+
+	return outStr;
+}
+
+string outcomeStr(const MoveOutcome& outcome)
+{
+	string outStr;
+	switch (outcome)
+	{
+		case MoveOutcome::MOVED:
+			outStr = "moved";
+			break;
+		
+		case MoveOutcome::OUT_OF_BOUNDS:
+			outStr = "out_of_bounds";
+			break;
+		
+		case MoveOutcome::WALL:
+			outStr = "wall";
+			break;
+		
+		case MoveOutcome::TRAVELER:
+			outStr = "traveler";
+			break;
+		
+		case MoveOutcome::PARTITION_BLOCKED:
+			outStr = "partition_blocked";
+			break;
+		
+		case MoveOutcome::LOST_RACE:
+			outStr = "lost_race";
+			break;
+		
+		case MoveOutcome::EXIT:
+			outStr = "exit";
+			break;
+		
+		default:
+			outStr = "";
+			break;
+	}
+	return outStr;
+}
+
+float** createTravelerColors(unsigned int numTravelers, Arena& arena)
+{
+	float** travelerColor = static_cast<float**>(arena.allocate(numTravelers * sizeof(float*), alignof(float*)));
+	float* rgbaBlock = static_cast<float*>(arena.allocate(4 * numTravelers * sizeof(float), alignof(float)));
+
+	float hueStep = 360.f / numTravelers;
+
+	for (unsigned int k=0; k<numTravelers; k++)
+	{
+		travelerColor[k] = rgbaBlock + 4*k;
+		travelerColor[k][3] = 1.f;					//  alpha --> full opacity
+
+		//	compute a hue for the traveler
+		float hue = k*hueStep;
+		//	convert the hue to an RGB color
+		int hueRegion = (int) (hue / 60);
+		switch (hueRegion)
+		{
+				//  hue in [0, 60] -- red-green, dominant red
+			case 0:
+				travelerColor[k][0] = 1.f;					//  red is max
+				travelerColor[k][1] = hue / 60.f;			//  green calculated
+				travelerColor[k][2] = 0.f;					//  blue is zero
+				break;
+
+				//  hue in [60, 120] -- red-green, dominant green
+			case 1:
+				travelerColor[k][0] = (120.f - hue) / 60.f;	//  red is calculated
+				travelerColor[k][1] = 1.f;					//  green max
+				travelerColor[k][2] = 0.f;					//  blue is zero
+				break;
+
+				//  hue in [120, 180] -- green-blue, dominant green
+			case 2:
+				travelerColor[k][0] = 0.f;					//  red is zero
+				travelerColor[k][1] = 1.f;					//  green max
+				travelerColor[k][2] = (hue - 120.f) / 60.f;	//  blue is calculated
+				break;
+
+				//  hue in [180, 240] -- green-blue, dominant blue
+			case 3:
+				travelerColor[k][0] = 0.f;					//  red is zero
+				travelerColor[k][1] = (240.f - hue) / 60;	//  green calculated
+				travelerColor[k][2] = 1.f;					//  blue is max
+				break;
+
+				//  hue in [240, 300] -- blue-red, dominant blue
+			case 4:
+				travelerColor[k][0] = (hue - 240.f) / 60;	//  red is calculated
+				travelerColor[k][1] = 0;						//  green is zero
+				travelerColor[k][2] = 1.f;					//  blue is max
+				break;
+
+				//  hue in [300, 360] -- blue-red, dominant red
+			case 5:
+				travelerColor[k][0] = 1.f;					//  red is max
+				travelerColor[k][1] = 0;						//  green is zero
+				travelerColor[k][2] = (360.f - hue) / 60;	//  blue is calculated
+				break;
+
+			default:
+				break;
+
+		}
+	}
+
+	return travelerColor;
+}
@@ -0,0 +1,147 @@
+//
+//  workerPool.cpp
+//  Final Project CSC412
+//
+
+#include <algorithm>
+//
+#include "workerPool.h"
+
+using namespace std;
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark Barrier
+//-----------------------------------------------------------------------------
+#endif
+
+Barrier::Barrier(unsigned int numThreads)
+	:	numThreads(numThreads),
+		numWaiting(0),
+		generation(0)
+{
+}
+
+void Barrier::arriveAndWait(const function<void()>& completion)
+{
+	unique_lock<mutex> guard(lock);
+	unsigned long myGeneration = generation;
+
+	if (++numWaiting == numThreads)
+	{
+		if (completion)
+			completion();
+		numWaiting = 0;
+		generation++;
+		released.notify_all();
+	}
+	else
+	{
+		released.wait(guard, [&]{ return generation != myGeneration; });
+	}
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark WorkDeque
+//-----------------------------------------------------------------------------
+#endif
+
+void WorkDeque::push(unsigned int item)
+{
+	lock_guard<mutex> guard(lock);
+	items.push_back(item);
+}
+
+size_t WorkDeque::popBatch(vector<unsigned int>& batch, size_t maxItems)
+{
+	lock_guard<mutex> guard(lock);
+	size_t n = min(maxItems, items.size());
+	for (size_t k=0; k<n; k++)
+	{
+		batch.push_back(items.back());
+		items.pop_back();
+	}
+	return n;
+}
+
+size_t WorkDeque::stealBatch(vector<unsigned int>& batch, size_t maxItems)
+{
+	lock_guard<mutex> guard(lock);
+	size_t n = min(maxItems, (items.size() + 1) / 2);
+	for (size_t k=0; k<n; k++)
+	{
+		batch.push_back(items.front());
+		items.pop_front();
+	}
+	return n;
+}
+
+#if 0
+//-----------------------------------------------------------------------------
+#pragma mark -
+#pragma mark WorkerPool
+//-----------------------------------------------------------------------------
+#endif
+
+WorkerPool::WorkerPool(unsigned int numWorkers)
+	:	job(nullptr),
+		jobGeneration(0),
+		numBusy(0),
+		quit(false)
+{
+	if (numWorkers == 0)
+		numWorkers = max(1U, thread::hardware_concurrency());
+
+	for (unsigned int k=0; k<numWorkers; k++)
+		workers.emplace_back(&WorkerPool::workerLoop, this, k);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		quit = true;
+	}
+	jobPosted.notify_all();
+	for (thread& t : workers)
+		t.join();
+}
+
+void WorkerPool::run(const function<void(unsigned int)>& newJob)
+{
+	unique_lock<mutex> guard(lock);
+	job = &newJob;
+	numBusy = size();
+	jobGeneration++;
+	jobPosted.notify_all();
+	jobDone.wait(guard, [&]{ return numBusy == 0; });
+	job = nullptr;
+}
+
+void WorkerPool::workerLoop(unsigned int index)
+{
+	unsigned long lastGeneration = 0;
+	while (true)
+	{
+		const function<void(unsigned int)>* myJob;
+		{
+			unique_lock<mutex> guard(lock);
+			jobPosted.wait(guard, [&]{ return quit || jobGeneration != lastGeneration; });
+			if (quit)
+				return;
+			lastGeneration = jobGeneration;
+			myJob = job;
+		}
+
+		(*myJob)(index);
+
+		{
+			lock_guard<mutex> guard(lock);
+			if (--numBusy == 0)
+				jobDone.notify_one();
+		}
+	}
+}
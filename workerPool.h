@@ -0,0 +1,104 @@
+//
+//  workerPool.h
+//  Final Project CSC412
+//
+//	A fixed pool of worker threads, plus the two small synchronization
+//	objects the engine builds on top of it:  a reusable barrier and a
+//	work-stealing deque of traveler indices.
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**	Reusable barrier for a fixed number of threads.
+ *	The last thread to arrive runs the completion function (if any) before
+ *	the others get released, so the completion sees a quiescent simulation.
+ */
+class Barrier
+{
+	public:
+
+		explicit Barrier(unsigned int numThreads);
+
+		/**	Blocks until numThreads threads have called this function
+		 *	@param completion run by the last thread to arrive, while the others wait
+		 */
+		void arriveAndWait(const std::function<void()>& completion = nullptr);
+
+	private:
+
+		std::mutex lock;
+		std::condition_variable released;
+		unsigned int numThreads;
+		unsigned int numWaiting;
+		unsigned long generation;
+};
+
+/**	Double-ended queue of work items (traveler indices).
+ *	The owner pushes and pops at the back, thieves steal from the front,
+ *	so the two only fight over the lock when the deque is nearly empty.
+ */
+class WorkDeque
+{
+	public:
+
+		void push(unsigned int item);
+
+		/**	Moves up to maxItems items from the back of the deque into batch
+		 *	@return the number of items moved
+		 */
+		size_t popBatch(std::vector<unsigned int>& batch, size_t maxItems);
+
+		/**	Moves up to half of the deque (at most maxItems) from its front into batch
+		 *	@return the number of items moved
+		 */
+		size_t stealBatch(std::vector<unsigned int>& batch, size_t maxItems);
+
+	private:
+
+		std::mutex lock;
+		std::deque<unsigned int> items;
+};
+
+/**	Fixed set of threads that all run the same job, fork-join style.
+ */
+class WorkerPool
+{
+	public:
+
+		/**	@param numWorkers number of threads (0 means one per hardware core)
+		 */
+		explicit WorkerPool(unsigned int numWorkers);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		unsigned int size() const { return static_cast<unsigned int>(workers.size()); }
+
+		/**	Runs job(workerIndex) on every worker and returns once they all returned
+		 */
+		void run(const std::function<void(unsigned int)>& job);
+
+	private:
+
+		void workerLoop(unsigned int index);
+
+		std::vector<std::thread> workers;
+		std::mutex lock;
+		std::condition_variable jobPosted;
+		std::condition_variable jobDone;
+		const std::function<void(unsigned int)>* job;
+		unsigned long jobGeneration;
+		unsigned int numBusy;
+		bool quit;
+};
+
+#endif //	WORKER_POOL_H